@@ -1,6 +1,7 @@
 #include <app.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <vertex.hpp>
+#include <algorithm>
 #include <bit>
 #include <cassert>
 #include <chrono>
@@ -16,9 +17,74 @@ namespace lvk {
 using namespace std::chrono_literals;
 
 namespace {
-template <typename T>
-[[nodiscard]] constexpr auto to_byte_array(T const& t) {
-	return std::bit_cast<std::array<std::byte, sizeof(T)>>(t);
+// time the framebuffer size must remain unchanged before the Swapchain is
+// recreated for it.
+constexpr auto resize_debounce_v = 100ms;
+
+// instances the frame arena initially has room for, it grows to fit more.
+constexpr std::size_t initial_instances_v{1024};
+// per-frame data: view UBO + instance, texture index and UV SSBOs, with room
+// for alignment.
+constexpr vk::DeviceSize frame_arena_capacity_v{2 * initial_instances_v *
+												sizeof(glm::mat4)};
+// slots of the bindless texture array, if supported.
+constexpr std::uint32_t bindless_capacity_v{4096};
+
+// bytes update_view() and update_instances() write into the frame arena:
+// the view matrix, and each instance's matrix, texture index and UV rect,
+// every allocation padded to alignment.
+[[nodiscard]] constexpr auto frame_arena_usage(std::size_t const instances,
+											   vk::DeviceSize const alignment)
+	-> vk::DeviceSize {
+	return sizeof(glm::mat4) +
+		   instances * (sizeof(glm::mat4) + sizeof(std::uint32_t) +
+						sizeof(glm::vec4)) +
+		   4 * alignment;
+}
+
+using Pixel = std::array<std::byte, 4>;
+
+// sprites packed into the texture atlas: size, and the colors of their 4x4
+// checkers.
+struct Sprite {
+	glm::ivec2 size{};
+	Pixel a{};
+	Pixel b{};
+};
+
+constexpr auto sprites_v = std::array{
+	Sprite{
+		.size = {16, 16},
+		.a = {std::byte{0xff}, std::byte{0x80}, {}, std::byte{0xff}},
+		.b = {std::byte{0xff}, std::byte{0xff}, std::byte{0xff},
+			  std::byte{0xff}},
+	},
+	Sprite{
+		.size = {32, 16},
+		.a = {{}, std::byte{0x80}, std::byte{0xff}, std::byte{0xff}},
+		.b = {{}, {}, {}, std::byte{0xff}},
+	},
+	Sprite{
+		.size = {24, 24},
+		.a = {std::byte{0x80}, std::byte{0xff}, {}, std::byte{0xff}},
+		.b = {std::byte{0x40}, std::byte{0x40}, std::byte{0x40},
+			  std::byte{0xff}},
+	},
+};
+
+[[nodiscard]] auto checker_bytes(Sprite const& sprite)
+	-> std::vector<std::byte> {
+	auto ret = std::vector<std::byte>{};
+	ret.reserve(static_cast<std::size_t>(sprite.size.x * sprite.size.y) *
+				sizeof(Pixel));
+	for (auto y = 0; y < sprite.size.y; ++y) {
+		for (auto x = 0; x < sprite.size.x; ++x) {
+			auto const even = (x / 4 + y / 4) % 2 == 0;
+			auto const& pixel = even ? sprite.a : sprite.b;
+			ret.insert(ret.end(), pixel.begin(), pixel.end());
+		}
+	}
+	return ret;
 }
 
 constexpr auto layout_binding(std::uint32_t binding,
@@ -87,27 +153,68 @@ constexpr auto layout_binding(std::uint32_t binding,
 
 void App::run() {
 	m_assets_dir = locate_assets_dir();
-
-	create_window();
+	m_create_info.frames_in_flight = std::clamp(
+		m_create_info.frames_in_flight, 1uz, max_resource_buffering_v);
+	m_jobs.emplace(m_create_info.job_workers.value_or(
+		JobSystem::default_worker_count()));
+	// load shaders while the instance and device are being created.
+	load_spir_v();
+
+	if (!m_create_info.headless) { create_window(); }
 	create_instance();
-	create_surface();
+	if (!m_create_info.headless) { create_surface(); }
 	select_gpu();
 	create_device();
 	create_allocator();
-	create_swapchain();
+	create_uploader();
+	if (m_create_info.headless) {
+		create_offscreen_ring();
+	} else {
+		create_swapchain();
+	}
 	create_render_sync();
+	create_recorder();
+	create_profiler();
 	create_imgui();
 	create_descriptor_pool();
+	create_bindless();
 	create_pipeline_layout();
 	create_shader();
-	create_cmd_block_pool();
 
 	create_shader_resources();
 	create_descriptor_sets();
+	create_defragmenter();
+	create_streamer();
+	create_atlas();
 
 	main_loop();
 }
 
+void App::load_spir_v() {
+	m_jobs->submit(
+		[this] { m_vertex_spir_v = to_spir_v(asset_path("shader.vert")); },
+		&m_spir_v_loaded);
+	m_jobs->submit(
+		[this] { m_fragment_spir_v = to_spir_v(asset_path("shader.frag")); },
+		&m_spir_v_loaded);
+	// optional: used if the GPU supports descriptor indexing.
+	if (!fs::exists(asset_path("bindless.vert")) ||
+		!fs::exists(asset_path("bindless.frag"))) {
+		return;
+	}
+	m_jobs->submit(
+		[this] {
+			m_bindless_vertex_spir_v = to_spir_v(asset_path("bindless.vert"));
+		},
+		&m_spir_v_loaded);
+	m_jobs->submit(
+		[this] {
+			m_bindless_fragment_spir_v =
+				to_spir_v(asset_path("bindless.frag"));
+		},
+		&m_spir_v_loaded);
+}
+
 void App::create_window() {
 	m_window = glfw::create_window({1280, 720}, "Learn Vulkan");
 }
@@ -125,7 +232,10 @@ void App::create_instance() {
 
 	auto instance_ci = vk::InstanceCreateInfo{};
 	// need WSI instance extensions here (platform-specific Swapchains).
-	auto const extensions = glfw::instance_extensions();
+	// headless rendering does not need any.
+	auto const extensions = m_create_info.headless
+								? std::span<char const* const>{}
+								: glfw::instance_extensions();
 	instance_ci.setPApplicationInfo(&app_info).setPEnabledExtensionNames(
 		extensions);
 
@@ -152,12 +262,20 @@ void App::select_gpu() {
 }
 
 void App::create_device() {
-	auto queue_ci = vk::DeviceQueueCreateInfo{};
-	// since we use only one queue, it has the entire priority range, ie, 1.0
+	auto queue_cis = std::vector<vk::DeviceQueueCreateInfo>{};
+	// since we use only one queue per family, it has the entire priority
+	// range, ie, 1.0
 	static constexpr auto queue_priorities_v = std::array{1.0f};
+	auto queue_ci = vk::DeviceQueueCreateInfo{};
 	queue_ci.setQueueFamilyIndex(m_gpu.queue_family)
 		.setQueueCount(1)
 		.setQueuePriorities(queue_priorities_v);
+	queue_cis.push_back(queue_ci);
+	// a dedicated queue for uploads, if the GPU has a transfer-only family.
+	if (m_gpu.transfer_family) {
+		queue_ci.setQueueFamilyIndex(*m_gpu.transfer_family);
+		queue_cis.push_back(queue_ci);
+	}
 
 	// nice-to-have optional core features, enable if GPU supports them.
 	auto enabled_features = vk::PhysicalDeviceFeatures{};
@@ -177,15 +295,34 @@ void App::create_device() {
 	auto shader_object_feature =
 		vk::PhysicalDeviceShaderObjectFeaturesEXT{vk::True};
 	dynamic_rendering_feature.setPNext(&shader_object_feature);
+	auto timeline_semaphore_feature =
+		vk::PhysicalDeviceTimelineSemaphoreFeatures{vk::True};
+	shader_object_feature.setPNext(&timeline_semaphore_feature);
+	// bindless textures, if supported.
+	auto descriptor_indexing_feature =
+		vk::PhysicalDeviceDescriptorIndexingFeatures{};
+	descriptor_indexing_feature.setRuntimeDescriptorArray(vk::True)
+		.setDescriptorBindingPartiallyBound(vk::True)
+		.setDescriptorBindingSampledImageUpdateAfterBind(vk::True)
+		.setDescriptorBindingUpdateUnusedWhilePending(vk::True)
+		.setShaderSampledImageArrayNonUniformIndexing(vk::True);
+	if (m_gpu.descriptor_indexing) {
+		timeline_semaphore_feature.setPNext(&descriptor_indexing_feature);
+	}
 
 	auto device_ci = vk::DeviceCreateInfo{};
 	// we need two device extensions: Swapchain and Shader Object.
-	static constexpr auto extensions_v = std::array{
-		VK_KHR_SWAPCHAIN_EXTENSION_NAME,
-		"VK_EXT_shader_object",
-	};
-	device_ci.setPEnabledExtensionNames(extensions_v)
-		.setQueueCreateInfos(queue_ci)
+	// headless rendering only needs Shader Object.
+	auto extensions = std::vector<char const*>{"VK_EXT_shader_object"};
+	if (!m_create_info.headless) {
+		extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+	}
+	// optional: lets VMA query heap budgets from the driver.
+	if (m_gpu.memory_budget) {
+		extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+	}
+	device_ci.setPEnabledExtensionNames(extensions)
+		.setQueueCreateInfos(queue_cis)
 		.setPEnabledFeatures(&enabled_features)
 		.setPNext(&sync_feature);
 
@@ -194,13 +331,27 @@ void App::create_device() {
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(*m_device);
 	static constexpr std::uint32_t queue_index_v{0};
 	m_queue = m_device->getQueue(m_gpu.queue_family, queue_index_v);
+	m_transfer_queue =
+		m_gpu.transfer_family
+			? m_device->getQueue(*m_gpu.transfer_family, queue_index_v)
+			: m_queue;
+	m_samplers.emplace(*m_device);
 
 	m_waiter = *m_device;
 }
 
 void App::create_swapchain() {
 	auto const size = glfw::framebuffer_size(m_window.get());
-	m_swapchain.emplace(*m_device, m_gpu, *m_surface, size);
+	m_swapchain.emplace(*m_device, m_gpu, *m_surface, size,
+						m_create_info.swapchain_policy);
+}
+
+void App::create_offscreen_ring() {
+	// one image per virtual frame: waiting for a frame's timeline value
+	// guarantees that its image is no longer in use.
+	m_offscreen.emplace(*m_device, m_allocator.get(), m_gpu.queue_family,
+						m_create_info.headless_size,
+						m_create_info.frames_in_flight);
 }
 
 void App::create_render_sync() {
@@ -214,26 +365,44 @@ void App::create_render_sync() {
 		.setQueueFamilyIndex(m_gpu.queue_family);
 	m_render_cmd_pool = m_device->createCommandPoolUnique(command_pool_ci);
 
+	m_render_sync.resize(m_create_info.frames_in_flight);
 	auto command_buffer_ai = vk::CommandBufferAllocateInfo{};
 	command_buffer_ai.setCommandPool(*m_render_cmd_pool)
-		.setCommandBufferCount(static_cast<std::uint32_t>(resource_buffering_v))
+		.setCommandBufferCount(
+			static_cast<std::uint32_t>(m_render_sync.size()))
 		.setLevel(vk::CommandBufferLevel::ePrimary);
 	auto const command_buffers =
 		m_device->allocateCommandBuffers(command_buffer_ai);
 	assert(command_buffers.size() == m_render_sync.size());
 
-	// we create Render Fences as pre-signaled so that on the first render for
-	// each virtual frame we don't wait on their fences (since there's nothing
-	// to wait for yet).
-	static constexpr auto fence_create_info_v =
-		vk::FenceCreateInfo{vk::FenceCreateFlagBits::eSignaled};
+	// each frame's drawn value starts at 0, the initial value of the timeline
+	// Semaphore, so that on the first render for each virtual frame we don't
+	// wait (since there's nothing to wait for yet).
 	for (auto [sync, command_buffer] :
 		 std::views::zip(m_render_sync, command_buffers)) {
 		sync.command_buffer = command_buffer;
 		sync.draw = m_device->createSemaphoreUnique({});
 		sync.present = m_device->createSemaphoreUnique({});
-		sync.drawn = m_device->createFenceUnique(fence_create_info_v);
 	}
+
+	auto semaphore_type_ci = vk::SemaphoreTypeCreateInfo{};
+	semaphore_type_ci.setSemaphoreType(vk::SemaphoreType::eTimeline)
+		.setInitialValue(0);
+	auto semaphore_ci = vk::SemaphoreCreateInfo{};
+	semaphore_ci.setPNext(&semaphore_type_ci);
+	m_render_timeline = m_device->createSemaphoreUnique(semaphore_ci);
+}
+
+void App::create_recorder() {
+	if (m_create_info.record_threads == 0) { return; }
+	m_recorder.emplace(*m_device, m_gpu.queue_family,
+					   m_create_info.frames_in_flight,
+					   m_create_info.record_threads, *m_jobs);
+}
+
+void App::create_profiler() {
+	m_profiler.emplace(*m_device, m_gpu, m_create_info.frames_in_flight,
+					   m_create_info.trace_path);
 }
 
 void App::create_imgui() {
@@ -245,38 +414,81 @@ void App::create_imgui() {
 		.queue_family = m_gpu.queue_family,
 		.device = *m_device,
 		.queue = m_queue,
-		.color_format = m_swapchain->get_format(),
+		.color_format = m_offscreen ? m_offscreen->get_format()
+									: m_swapchain->get_format(),
 		.samples = vk::SampleCountFlagBits::e1,
+		.buffering = static_cast<std::uint32_t>(m_create_info.frames_in_flight),
+		.display_size = m_create_info.headless_size,
 	};
 	m_imgui.emplace(imgui_ci);
 }
 
 void App::create_allocator() {
-	m_allocator = vma::create_allocator(*m_instance, m_gpu.device, *m_device);
+	m_allocator = vma::create_allocator(*m_instance, m_gpu.device, *m_device,
+										m_gpu.memory_budget);
+	m_memory.emplace(m_allocator.get());
+}
+
+void App::create_uploader() {
+	auto const uploader_ci = AsyncUploader::CreateInfo{
+		.device = *m_device,
+		.allocator = m_allocator.get(),
+		.queue_family = m_gpu.queue_family,
+		.transfer_family = m_gpu.transfer_family,
+		.queue = m_transfer_queue,
+	};
+	m_uploader.emplace(uploader_ci);
+	if (m_gpu.transfer_family) {
+		spdlog::info("Using transfer queue family: {}",
+					 *m_gpu.transfer_family);
+	}
 }
 
 void App::create_descriptor_pool() {
 	static constexpr auto pool_sizes_v = std::array{
-		// 2 uniform buffers, can be more if desired.
-		vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, 2},
-		vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, 2},
-		vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, 2},
+		// the frame arena's sets are replaced when its Buffer is reallocated.
+		vk::DescriptorPoolSize{vk::DescriptorType::eUniformBufferDynamic, 8},
+		// the texture's set is replaced when it is moved.
+		vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, 4},
+		vk::DescriptorPoolSize{vk::DescriptorType::eStorageBufferDynamic, 24},
 	};
 	auto pool_ci = vk::DescriptorPoolCreateInfo{};
-	// allow 16 sets to be allocated from this pool.
-	pool_ci.setPoolSizes(pool_sizes_v).setMaxSets(16);
+	// allow 32 sets to be allocated from this pool, and individual sets to be
+	// freed.
+	pool_ci.setPoolSizes(pool_sizes_v)
+		.setMaxSets(32)
+		.setFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
 	m_descriptor_pool = m_device->createDescriptorPoolUnique(pool_ci);
 }
 
+void App::create_bindless() {
+	// the bindless shaders may not have been loaded yet.
+	m_jobs->wait(m_spir_v_loaded);
+	if (!m_gpu.descriptor_indexing || m_bindless_vertex_spir_v.empty() ||
+		m_bindless_fragment_spir_v.empty()) {
+		return;
+	}
+	auto const bindless_ci = BindlessTexturesCreateInfo{
+		.device = *m_device,
+		.capacity = std::min(bindless_capacity_v, m_gpu.max_bindless_textures),
+	};
+	m_bindless.emplace(bindless_ci);
+	spdlog::info("[lvk] Using bindless textures: {} slots",
+				 m_bindless->get_capacity());
+}
+
 void App::create_pipeline_layout() {
 	static constexpr auto set_0_bindings_v = std::array{
-		layout_binding(0, vk::DescriptorType::eUniformBuffer),
+		layout_binding(0, vk::DescriptorType::eUniformBufferDynamic),
 	};
 	static constexpr auto set_1_bindings_v = std::array{
 		layout_binding(0, vk::DescriptorType::eCombinedImageSampler),
 	};
 	static constexpr auto set_2_bindings_v = std::array{
-		layout_binding(0, vk::DescriptorType::eStorageBuffer),
+		layout_binding(0, vk::DescriptorType::eStorageBufferDynamic),
+		// texture indices and UV rects, only read by the bindless shaders.
+		layout_binding(1, vk::DescriptorType::eStorageBufferDynamic),
+		layout_binding(2, vk::DescriptorType::eStorageBufferDynamic),
 	};
 	auto set_layout_cis = std::array<vk::DescriptorSetLayoutCreateInfo, 3>{};
 	set_layout_cis[0].setBindings(set_0_bindings_v);
@@ -288,6 +500,8 @@ void App::create_pipeline_layout() {
 			m_device->createDescriptorSetLayoutUnique(set_layout_ci));
 		m_set_layout_views.push_back(*m_set_layouts.back());
 	}
+	// the texture array replaces the per-texture set.
+	if (m_bindless) { m_set_layout_views[1] = m_bindless->get_layout(); }
 
 	auto pipeline_layout_ci = vk::PipelineLayoutCreateInfo{};
 	pipeline_layout_ci.setSetLayouts(m_set_layout_views);
@@ -296,8 +510,14 @@ void App::create_pipeline_layout() {
 }
 
 void App::create_shader() {
-	auto const vertex_spirv = to_spir_v(asset_path("shader.vert"));
-	auto const fragment_spirv = to_spir_v(asset_path("shader.frag"));
+	// help load the SPIR-V if it is not ready yet.
+	m_jobs->wait(m_spir_v_loaded);
+	// the bindless variants index set 1's texture array per instance.
+	auto const vertex_spirv = m_bindless ? std::move(m_bindless_vertex_spir_v)
+										 : std::move(m_vertex_spir_v);
+	auto const fragment_spirv = m_bindless
+									? std::move(m_bindless_fragment_spir_v)
+									: std::move(m_fragment_spir_v);
 
 	static constexpr auto vertex_input_v = ShaderVertexInput{
 		.attributes = vertex_attributes_v,
@@ -313,16 +533,6 @@ void App::create_shader() {
 	m_shader.emplace(shader_ci);
 }
 
-void App::create_cmd_block_pool() {
-	auto command_pool_ci = vk::CommandPoolCreateInfo{};
-	command_pool_ci
-		.setQueueFamilyIndex(m_gpu.queue_family)
-		// this flag indicates that the allocated Command Buffers will be
-		// short-lived.
-		.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
-	m_cmd_block_pool = m_device->createCommandPoolUnique(command_pool_ci);
-}
-
 void App::create_shader_resources() {
 	// vertices of a quad.
 	static constexpr auto vertices_v = std::array{
@@ -334,30 +544,31 @@ void App::create_shader_resources() {
 	static constexpr auto indices_v = std::array{
 		0u, 1u, 2u, 2u, 3u, 0u,
 	};
-	static constexpr auto vertices_bytes_v = to_byte_array(vertices_v);
-	static constexpr auto indices_bytes_v = to_byte_array(indices_v);
-	static constexpr auto total_bytes_v =
-		std::array<std::span<std::byte const>, 2>{
-			vertices_bytes_v,
-			indices_bytes_v,
-		};
-	// we want to write total_bytes_v to a Device VertexBuffer | IndexBuffer.
-	auto const buffer_ci = vma::BufferCreateInfo{
+	// all uploads are recorded into one batch and submitted once. they are
+	// not waited on here: the first frame's submission waits for them on the
+	// GPU.
+	auto batch = m_uploader->begin_batch();
+	// meshes are sub-allocated from one Device VertexBuffer | IndexBuffer.
+	m_geometry.emplace(GeometryPoolCreateInfo{
 		.allocator = m_allocator.get(),
-		.usage = vk::BufferUsageFlagBits::eVertexBuffer |
-				 vk::BufferUsageFlagBits::eIndexBuffer,
 		.queue_family = m_gpu.queue_family,
-	};
-	m_vbo = vma::create_device_buffer(buffer_ci, create_command_block(),
-									  total_bytes_v);
+	});
+	auto const quad = m_geometry->add_mesh(batch, vertices_v, indices_v);
+	if (!quad) { throw std::runtime_error{"Failed to add quad geometry"}; }
+	m_quad = *quad;
 
-	m_view_ubo.emplace(m_allocator.get(), m_gpu.queue_family,
-					   vk::BufferUsageFlagBits::eUniformBuffer);
-
-	m_instance_ssbo.emplace(m_allocator.get(), m_gpu.queue_family,
-							vk::BufferUsageFlagBits::eStorageBuffer);
+	auto const& limits = m_gpu.properties.limits;
+	auto const arena_ci = FrameArenaCreateInfo{
+		.allocator = m_allocator.get(),
+		.queue_family = m_gpu.queue_family,
+		.uniform_alignment = limits.minUniformBufferOffsetAlignment,
+		.storage_alignment = limits.minStorageBufferOffsetAlignment,
+		.buffering = m_create_info.frames_in_flight,
+		.frame_capacity = frame_arena_capacity_v,
+		.deferred = &m_deferred,
+	};
+	m_frame_arena.emplace(arena_ci);
 
-	using Pixel = std::array<std::byte, 4>;
 	static constexpr auto rgby_pixels_v = std::array{
 		Pixel{std::byte{0xff}, {}, {}, std::byte{0xff}},
 		Pixel{std::byte{}, std::byte{0xff}, {}, std::byte{0xff}},
@@ -371,42 +582,118 @@ void App::create_shader_resources() {
 		.bytes = rgby_bytes_v,
 		.size = {2, 2},
 	};
-	auto texture_ci = Texture::CreateInfo{
+	// use Nearest filtering instead of Linear (interpolation).
+	auto sampler_ci = sampler_ci_v;
+	sampler_ci.setMagFilter(vk::Filter::eNearest);
+	m_texture.emplace(*m_device, batch.add_image(rgby_bitmap_v), sampler_ci,
+					  &*m_samplers);
+	if (m_bindless) {
+		auto const index = m_bindless->add(m_texture->descriptor_info());
+		if (!index) {
+			throw std::runtime_error{"Out of bindless texture slots"};
+		}
+		m_texture_index = *index;
+	}
+
+	m_uploader->submit(std::move(batch));
+}
+
+void App::create_descriptor_sets() {
+	m_descriptor_sets = allocate_sets();
+	write_descriptor_sets();
+}
+
+void App::create_defragmenter() {
+	auto const defrag_ci = DefragmenterCreateInfo{
 		.device = *m_device,
 		.allocator = m_allocator.get(),
-		.queue_family = m_gpu.queue_family,
-		.command_block = create_command_block(),
-		.bitmap = rgby_bitmap_v,
+		.deferred = &m_deferred,
 	};
-	// use Nearest filtering instead of Linear (interpolation).
-	texture_ci.sampler.setMagFilter(vk::Filter::eNearest);
-	m_texture.emplace(std::move(texture_ci));
+	m_defrag.emplace(defrag_ci);
+	// the geometry pool is bound by handle every frame, nothing to refresh.
+	m_defrag->track(m_geometry->get_buffer());
+	m_defrag->track(m_texture->get_image(), [this] {
+		m_texture->refresh_view(m_deferred);
+		replace_texture_set();
+	});
 }
 
-void App::create_descriptor_sets() {
-	for (auto& descriptor_sets : m_descriptor_sets) {
-		descriptor_sets = allocate_sets();
+void App::create_streamer() {
+	auto streamer_ci = TextureStreamerCreateInfo{
+		.device = *m_device,
+		.uploader = &*m_uploader,
+		.jobs = &*m_jobs,
+		.set_layout = m_set_layout_views[1],
+		.bindless = m_bindless ? &*m_bindless : nullptr,
+		.samplers = &*m_samplers,
+	};
+	if (m_create_info.compress_textures) {
+		streamer_ci.compression = BlockEncodeSettings{.jobs = &*m_jobs};
+	}
+	m_streamer.emplace(streamer_ci);
+	if (!m_create_info.texture_path.empty()) {
+		m_streamed = m_streamer->request(m_create_info.texture_path);
 	}
 }
 
-auto App::asset_path(std::string_view const uri) const -> fs::path {
-	return m_assets_dir / uri;
+void App::create_atlas() {
+	// pages are only selectable per instance through the texture array.
+	if (!m_bindless) { return; }
+	auto const atlas_ci = TextureAtlasCreateInfo{
+		.device = *m_device,
+		.allocator = m_allocator.get(),
+		.queue_family = m_gpu.queue_family,
+		.page_size = 256,
+		.max_pages = 1,
+		.samplers = &*m_samplers,
+	};
+	m_atlas.emplace(atlas_ci);
+	// uploaded by the first frame's record().
+	for (auto const& sprite : sprites_v) {
+		auto const bytes = checker_bytes(sprite);
+		auto const entry =
+			m_atlas->insert(Bitmap{.bytes = bytes, .size = sprite.size});
+		if (!entry) {
+			spdlog::error("[lvk] Failed to insert {}x{} sprite into atlas",
+						  sprite.size.x, sprite.size.y);
+			continue;
+		}
+		m_sprites.push_back(*entry);
+	}
+	for (auto page = 0u; page < m_atlas->get_page_count(); ++page) {
+		auto const index =
+			m_bindless->add(m_atlas->get_page(page).descriptor_info());
+		if (!index) {
+			throw std::runtime_error{"Out of bindless texture slots"};
+		}
+		m_atlas_slots.push_back(*index);
+	}
 }
 
-auto App::create_command_block() const -> CommandBlock {
-	return CommandBlock{*m_device, m_queue, *m_cmd_block_pool};
+auto App::asset_path(std::string_view const uri) const -> fs::path {
+	return m_assets_dir / uri;
 }
 
 auto App::allocate_sets() const -> std::vector<vk::DescriptorSet> {
 	auto allocate_info = vk::DescriptorSetAllocateInfo{};
-	allocate_info.setDescriptorPool(*m_descriptor_pool)
-		.setSetLayouts(m_set_layout_views);
-	return m_device->allocateDescriptorSets(allocate_info);
+	allocate_info.setDescriptorPool(*m_descriptor_pool);
+	if (!m_bindless) {
+		allocate_info.setSetLayouts(m_set_layout_views);
+		return m_device->allocateDescriptorSets(allocate_info);
+	}
+	// the texture array is allocated from its own (update after bind) pool.
+	auto const set_layouts =
+		std::array{m_set_layout_views[0], m_set_layout_views[2]};
+	allocate_info.setSetLayouts(set_layouts);
+	auto const sets = m_device->allocateDescriptorSets(allocate_info);
+	return {sets[0], m_bindless->get_set(), sets[1]};
 }
 
 void App::main_loop() {
-	while (glfwWindowShouldClose(m_window.get()) == GLFW_FALSE) {
-		glfwPollEvents();
+	auto const start = std::chrono::steady_clock::now();
+	while (!should_close()) {
+		auto const zone = m_profiler->cpu_zone("frame");
+		if (m_window) { glfwPollEvents(); }
 		if (!acquire_render_target()) { continue; }
 		auto const command_buffer = begin_frame();
 		transition_for_render(command_buffer);
@@ -414,10 +701,43 @@ void App::main_loop() {
 		transition_for_present(command_buffer);
 		submit_and_present();
 	}
+
+	auto const elapsed = std::chrono::duration<double>{
+		std::chrono::steady_clock::now() - start};
+	auto const fps =
+		static_cast<double>(m_frame_count) / std::max(elapsed.count(), 1e-9);
+	spdlog::info("[lvk] Rendered {} frames in {:.3f}s ({:.1f} FPS)",
+				 m_frame_count, elapsed.count(), fps);
+	if (m_swapchain) { m_swapchain->log_latency(); }
+	auto const& upload_stats = m_uploader->get_stats();
+	spdlog::info("[lvk] Uploads: Command Buffers {} created, {} reused",
+				 upload_stats.command_buffers_created,
+				 upload_stats.command_buffers_reused);
+	auto const& arena_stats = m_frame_arena->get_stats();
+	spdlog::info("[lvk] Frame Arena: {} grows, {} shrinks, {} failed "
+				 "allocations",
+				 arena_stats.grows, arena_stats.shrinks, arena_stats.failures);
+	auto const sampler_stats = m_samplers->get_stats();
+	spdlog::info("[lvk] Samplers: {} created, {} reused, {} live",
+				 sampler_stats.misses, sampler_stats.hits, sampler_stats.live);
+	m_memory->log_summary();
+	if (!m_create_info.memory_stats_path.empty()) {
+		m_memory->write_json(m_create_info.memory_stats_path, true);
+	}
+}
+
+auto App::should_close() const -> bool {
+	if (m_create_info.headless) {
+		return m_frame_count >= m_create_info.frame_count;
+	}
+	return glfwWindowShouldClose(m_window.get()) == GLFW_TRUE;
 }
 
 auto App::acquire_render_target() -> bool {
-	m_framebuffer_size = glfw::framebuffer_size(m_window.get());
+	auto const zone = m_profiler->cpu_zone("acquire_render_target");
+	m_framebuffer_size = m_offscreen
+							 ? m_offscreen->get_size()
+							 : glfw::framebuffer_size(m_window.get());
 	// minimized? skip loop.
 	if (m_framebuffer_size.x <= 0 || m_framebuffer_size.y <= 0) {
 		return false;
@@ -425,25 +745,46 @@ auto App::acquire_render_target() -> bool {
 
 	auto& render_sync = m_render_sync.at(m_frame_index);
 
-	// wait for the fence to be signaled.
-	static constexpr auto fence_timeout_v =
+	// wait for the frame's previous submission to be drawn.
+	static constexpr auto timeout_v =
 		static_cast<std::uint64_t>(std::chrono::nanoseconds{3s}.count());
-	auto result =
-		m_device->waitForFences(*render_sync.drawn, vk::True, fence_timeout_v);
+	auto semaphore_wi = vk::SemaphoreWaitInfo{};
+	semaphore_wi.setSemaphores(*m_render_timeline)
+		.setValues(render_sync.drawn);
+	auto const result = m_device->waitSemaphores(semaphore_wi, timeout_v);
 	if (result != vk::Result::eSuccess) {
-		throw std::runtime_error{"Failed to wait for Render Fence"};
+		throw std::runtime_error{"Failed to wait for Render Timeline"};
 	}
 
-	m_render_target = m_swapchain->acquire_next_image(*render_sync.draw);
+	// destroy resources released (and Swapchains retired) in previous frames
+	// once those frames have been drawn.
+	auto const drawn = m_device->getSemaphoreCounterValue(*m_render_timeline);
+	m_deferred.collect(drawn);
+	if (m_bindless) { m_bindless->collect(drawn); }
+	m_uploader->collect();
+	// before record_acquires(): its uploads are acquired by this frame.
+	m_streamer->update();
+	m_defrag->update(drawn);
+	auto const& limits = m_gpu.properties.limits;
+	m_frame_arena->reserve(frame_arena_usage(
+		m_instances.size(), std::max(limits.minUniformBufferOffsetAlignment,
+									 limits.minStorageBufferOffsetAlignment)));
+	// frames in flight keep using the previous Buffer through their sets.
+	if (m_frame_arena->begin_frame(m_frame_index)) { replace_arena_sets(); }
+
+	if (m_offscreen) {
+		// offscreen images are always available, nothing to signal.
+		m_render_target = m_offscreen->acquire_next_image();
+	} else {
+		m_swapchain->destroy_retired(drawn);
+		m_render_target = m_swapchain->acquire_next_image(*render_sync.draw);
+	}
 	if (!m_render_target) {
 		// acquire failure => ErrorOutOfDate. Recreate Swapchain.
 		m_swapchain->recreate(m_framebuffer_size);
 		return false;
 	}
 
-	// reset fence _after_ acquisition of image: if it fails, the
-	// fence remains signaled.
-	m_device->resetFences(*render_sync.drawn);
 	m_imgui->new_frame();
 
 	return true;
@@ -456,12 +797,30 @@ auto App::begin_frame() -> vk::CommandBuffer {
 	// this flag means recorded commands will not be reused.
 	command_buffer_bi.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 	render_sync.command_buffer.begin(command_buffer_bi);
+	// resources released while recording may be used by this frame.
+	m_deferred.begin_frame(m_frame_count + 1);
+	m_profiler->begin_frame(render_sync.command_buffer, m_frame_index);
+	// acquire ownership of uploaded resources before they are used.
+	m_upload_wait = m_uploader->record_acquires(render_sync.command_buffer);
+	// don't move resources with uploads in flight.
+	if (m_uploader->is_complete(m_upload_wait)) {
+		m_defrag->record(render_sync.command_buffer, m_frame_count + 1);
+	}
+	// sprites inserted since the last frame, sampled by this one.
+	if (m_atlas) { m_atlas->record(render_sync.command_buffer, m_deferred); }
 	return render_sync.command_buffer;
 }
 
-void App::transition_for_render(vk::CommandBuffer const command_buffer) const {
+auto App::base_barrier() const -> vk::ImageMemoryBarrier2 {
+	if (m_offscreen) { return m_offscreen->base_barrier(); }
+	return m_swapchain->base_barrier();
+}
+
+void App::transition_for_render(vk::CommandBuffer const command_buffer) {
+	auto const zone =
+		m_profiler->gpu_zone(command_buffer, "transition_for_render");
 	auto dependency_info = vk::DependencyInfo{};
-	auto barrier = m_swapchain->base_barrier();
+	auto barrier = base_barrier();
 	// Undefined => AttachmentOptimal
 	// the barrier must wait for prior color attachment operations to complete,
 	// and block subsequent ones.
@@ -491,12 +850,33 @@ void App::render(vk::CommandBuffer const command_buffer) {
 		.setColorAttachments(color_attachment)
 		.setLayerCount(1);
 
-	command_buffer.beginRendering(rendering_info);
-	inspect();
-	update_view();
-	update_instances();
-	draw(command_buffer);
-	command_buffer.endRendering();
+	{
+		auto const zone = m_profiler->gpu_zone(command_buffer, "scene_pass");
+		inspect();
+		// stale dynamic offsets would point into another frame's region:
+		// draw nothing this frame, the arena grows to fit by the next one.
+		m_draw_count = 0;
+		if (update_view() && update_instances()) {
+			m_draw_count = static_cast<std::uint32_t>(m_instances.size());
+		} else {
+			spdlog::error("[lvk] Frame arena out of space, skipping {} "
+						  "instances",
+						  m_instances.size());
+		}
+		m_frame_arena->commit(command_buffer);
+		if (m_recorder) {
+			// the scene pass only executes secondary Command Buffers.
+			rendering_info.setFlags(
+				vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+			command_buffer.beginRendering(rendering_info);
+			draw_parallel(command_buffer);
+			rendering_info.setFlags({});
+		} else {
+			command_buffer.beginRendering(rendering_info);
+			draw(command_buffer);
+		}
+		command_buffer.endRendering();
+	}
 
 	m_imgui->end_frame();
 	// we don't want to clear the image again, instead load it intact after the
@@ -504,19 +884,24 @@ void App::render(vk::CommandBuffer const command_buffer) {
 	color_attachment.setLoadOp(vk::AttachmentLoadOp::eLoad);
 	rendering_info.setColorAttachments(color_attachment)
 		.setPDepthAttachment(nullptr);
+	auto const zone = m_profiler->gpu_zone(command_buffer, "imgui_pass");
 	command_buffer.beginRendering(rendering_info);
 	m_imgui->render(command_buffer);
 	command_buffer.endRendering();
 }
 
-void App::transition_for_present(vk::CommandBuffer const command_buffer) const {
+void App::transition_for_present(vk::CommandBuffer const command_buffer) {
+	auto const zone =
+		m_profiler->gpu_zone(command_buffer, "transition_for_present");
 	auto dependency_info = vk::DependencyInfo{};
-	auto barrier = m_swapchain->base_barrier();
-	// AttachmentOptimal => PresentSrc
+	auto barrier = base_barrier();
+	// AttachmentOptimal => PresentSrc (TransferSrc for offscreen images)
 	// the barrier must wait for prior color attachment operations to complete,
 	// and block subsequent ones.
+	auto const final_layout = m_offscreen ? vk::ImageLayout::eTransferSrcOptimal
+										  : vk::ImageLayout::ePresentSrcKHR;
 	barrier.setOldLayout(vk::ImageLayout::eAttachmentOptimal)
-		.setNewLayout(vk::ImageLayout::ePresentSrcKHR)
+		.setNewLayout(final_layout)
 		.setSrcAccessMask(vk::AccessFlagBits2::eColorAttachmentRead |
 						  vk::AccessFlagBits2::eColorAttachmentWrite)
 		.setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
@@ -527,39 +912,83 @@ void App::transition_for_present(vk::CommandBuffer const command_buffer) const {
 }
 
 void App::submit_and_present() {
-	auto const& render_sync = m_render_sync.at(m_frame_index);
+	auto& render_sync = m_render_sync.at(m_frame_index);
 	render_sync.command_buffer.end();
 
 	auto submit_info = vk::SubmitInfo2{};
 	auto const command_buffer_info =
 		vk::CommandBufferSubmitInfo{render_sync.command_buffer};
-	auto wait_semaphore_info = vk::SemaphoreSubmitInfo{};
-	wait_semaphore_info.setSemaphore(*render_sync.draw)
+	submit_info.setCommandBufferInfos(command_buffer_info);
+	auto wait_semaphore_infos = std::array<vk::SemaphoreSubmitInfo, 2>{};
+	// wait for uploads used by this frame.
+	wait_semaphore_infos[0]
+		.setSemaphore(m_uploader->get_timeline())
+		.setValue(m_upload_wait.value)
+		.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+	wait_semaphore_infos[1]
+		.setSemaphore(*render_sync.draw)
 		.setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
-	auto signal_semaphore_info = vk::SemaphoreSubmitInfo{};
-	signal_semaphore_info.setSemaphore(*render_sync.present)
+	// this frame is drawn once the timeline reaches the new frame count.
+	render_sync.drawn = ++m_frame_count;
+	auto signal_semaphore_infos = std::array<vk::SemaphoreSubmitInfo, 2>{};
+	signal_semaphore_infos[0]
+		.setSemaphore(*m_render_timeline)
+		.setValue(render_sync.drawn)
+		.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+	signal_semaphore_infos[1]
+		.setSemaphore(*render_sync.present)
 		.setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
-	submit_info.setCommandBufferInfos(command_buffer_info)
-		.setWaitSemaphoreInfos(wait_semaphore_info)
-		.setSignalSemaphoreInfos(signal_semaphore_info);
-	m_queue.submit2(submit_info, *render_sync.drawn);
+	if (m_offscreen) {
+		// offscreen images are neither acquired nor presented.
+		submit_info.setWaitSemaphoreInfos(wait_semaphore_infos[0])
+			.setSignalSemaphoreInfos(signal_semaphore_infos[0]);
+	} else {
+		submit_info.setWaitSemaphoreInfos(wait_semaphore_infos)
+			.setSignalSemaphoreInfos(signal_semaphore_infos);
+	}
+	m_queue.submit2(submit_info);
 
 	m_frame_index = (m_frame_index + 1) % m_render_sync.size();
 	m_render_target.reset();
 
+	if (m_offscreen) {
+		m_offscreen->present();
+		return;
+	}
+
 	// an eErrorOutOfDateKHR result is not guaranteed if the
 	// framebuffer size does not match the Swapchain image size, check it
 	// explicitly.
 	auto const fb_size_changed = m_framebuffer_size != m_swapchain->get_size();
-	auto const out_of_date =
-		!m_swapchain->present(m_queue, *render_sync.present);
-	if (fb_size_changed || out_of_date) {
+	auto const out_of_date = !m_swapchain->present(
+		m_queue, *render_sync.present, render_sync.drawn);
+	auto const& latency = m_swapchain->get_latency();
+	m_profiler->record_cpu("acquire_to_present", latency.acquired,
+						   latency.presented);
+
+	// while the window is being resized, wait for its size to settle before
+	// recreating the Swapchain (unless it cannot be presented to anymore).
+	auto const now = std::chrono::steady_clock::now();
+	if (m_framebuffer_size != m_resize_size) {
+		m_resize_size = m_framebuffer_size;
+		m_resize_time = now;
+	}
+	auto const resize_settled =
+		fb_size_changed && now - m_resize_time >= resize_debounce_v;
+
+	if (m_pending_policy) {
+		m_swapchain->recreate(m_framebuffer_size, *m_pending_policy);
+		m_pending_policy.reset();
+	} else if (resize_settled || out_of_date) {
 		m_swapchain->recreate(m_framebuffer_size);
 	}
 }
 
 void App::inspect() {
+	auto const zone = m_profiler->cpu_zone("inspect");
 	ImGui::ShowDemoWindow();
+	m_profiler->inspect();
+	m_memory->inspect();
 
 	ImGui::SetNextWindowSize({200.0f, 100.0f}, ImGuiCond_Once);
 	if (ImGui::Begin("Inspect")) {
@@ -581,6 +1010,74 @@ void App::inspect() {
 			ImGui::DragFloat2("scale", &out.scale.x, 0.1f);
 		};
 
+		if (m_swapchain) {
+			ImGui::Separator();
+			if (ImGui::TreeNode("Swapchain")) {
+				inspect_swapchain();
+				ImGui::TreePop();
+			}
+		}
+
+		ImGui::Separator();
+		if (ImGui::TreeNode("Defragmentation")) {
+			m_defrag->inspect();
+			ImGui::TreePop();
+		}
+
+		ImGui::Separator();
+		if (ImGui::TreeNode("Samplers")) {
+			auto const stats = m_samplers->get_stats();
+			ImGui::Text("live: %llu / %u",
+						static_cast<unsigned long long>(stats.live),
+						m_gpu.properties.limits.maxSamplerAllocationCount);
+			ImGui::Text("created: %llu, reused: %llu",
+						static_cast<unsigned long long>(stats.misses),
+						static_cast<unsigned long long>(stats.hits));
+			ImGui::TreePop();
+		}
+
+		ImGui::Separator();
+		if (ImGui::TreeNode("Frame Arena")) {
+			auto const& stats = m_frame_arena->get_stats();
+			ImGui::Text("used: %llu / %llu bytes",
+						static_cast<unsigned long long>(
+							m_frame_arena->get_frame_used()),
+						static_cast<unsigned long long>(
+							m_frame_arena->get_frame_capacity()));
+			ImGui::Text("grows: %llu, shrinks: %llu, failures: %llu",
+						static_cast<unsigned long long>(stats.grows),
+						static_cast<unsigned long long>(stats.shrinks),
+						static_cast<unsigned long long>(stats.failures));
+			ImGui::TreePop();
+		}
+
+		if (m_atlas) {
+			ImGui::Separator();
+			if (ImGui::TreeNode("Texture Atlas")) {
+				auto const stats = m_atlas->get_stats();
+				for (auto page = 0u; page < m_atlas->get_page_count();
+					 ++page) {
+					ImGui::Text("page %u: %.1f%% occupied", page,
+								100.0f * m_atlas->get_occupancy(page));
+				}
+				ImGui::Text("inserted: %llu, rejected: %llu",
+							static_cast<unsigned long long>(stats.insertions),
+							static_cast<unsigned long long>(stats.rejections));
+				ImGui::Text("uploaded: %llu regions, %llu bytes",
+							static_cast<unsigned long long>(
+								stats.regions_uploaded),
+							static_cast<unsigned long long>(
+								stats.bytes_uploaded));
+				ImGui::TreePop();
+			}
+		}
+
+		ImGui::Separator();
+		if (ImGui::TreeNode("Texture Streaming")) {
+			m_streamer->inspect();
+			ImGui::TreePop();
+		}
+
 		ImGui::Separator();
 		if (ImGui::TreeNode("View")) {
 			inspect_transform(m_view_transform);
@@ -602,7 +1099,43 @@ void App::inspect() {
 	ImGui::End();
 }
 
-void App::update_view() {
+void App::inspect_swapchain() {
+	static constexpr auto present_modes_v = std::array{
+		vk::PresentModeKHR::eFifo,
+		vk::PresentModeKHR::eFifoRelaxed,
+		vk::PresentModeKHR::eMailbox,
+		vk::PresentModeKHR::eImmediate,
+	};
+	auto policy = m_pending_policy.value_or(m_swapchain->get_policy());
+	auto changed = false;
+	auto const preview = vk::to_string(policy.present_mode);
+	if (ImGui::BeginCombo("present mode", preview.c_str())) {
+		for (auto const mode : present_modes_v) {
+			auto const name = vk::to_string(mode);
+			if (ImGui::Selectable(name.c_str(), mode == policy.present_mode)) {
+				policy.present_mode = mode;
+				changed = true;
+			}
+		}
+		ImGui::EndCombo();
+	}
+	auto image_count = static_cast<int>(policy.image_count);
+	if (ImGui::SliderInt("images", &image_count, 2, 8)) {
+		policy.image_count = static_cast<std::uint32_t>(image_count);
+		changed = true;
+	}
+	if (changed) { m_pending_policy = policy; }
+
+	auto const active = vk::to_string(m_swapchain->get_present_mode());
+	ImGui::Text("active: %s, %zu images", active.c_str(),
+				m_swapchain->get_image_count());
+	auto const& latency = m_swapchain->get_latency();
+	using Ms = std::chrono::duration<double, std::milli>;
+	ImGui::Text("acquire to present: %.3fms (max %.3fms)",
+				Ms{latency.average()}.count(), Ms{latency.max}.count());
+}
+
+auto App::update_view() -> bool {
 	auto const half_size = 0.5f * glm::vec2{m_framebuffer_size};
 	auto const mat_projection =
 		glm::ortho(-half_size.x, half_size.x, -half_size.y, half_size.y);
@@ -610,72 +1143,210 @@ void App::update_view() {
 	auto const mat_vp = mat_projection * mat_view;
 	auto const bytes =
 		std::bit_cast<std::array<std::byte, sizeof(mat_vp)>>(mat_vp);
-	m_view_ubo->write_at(m_frame_index, bytes);
+	auto const allocation = m_frame_arena->write_uniform(bytes);
+	if (!allocation) { return false; }
+	m_dynamic_offsets[0] = allocation->offset;
+	return true;
 }
 
-void App::update_instances() {
-	m_instance_data.clear();
-	m_instance_data.reserve(m_instances.size());
-	for (auto const& transform : m_instances) {
-		m_instance_data.push_back(transform.model_matrix());
-	}
+auto App::update_instances() -> bool {
+	auto const zone = m_profiler->cpu_zone("update_instances");
+	// matrices per job.
+	static constexpr std::size_t grain_v{1024};
+	m_instance_data.resize(m_instances.size());
+	m_instance_textures.resize(m_instances.size());
+	m_instance_uvs.resize(m_instances.size());
+	m_jobs->parallel_for(
+		m_instances.size(), grain_v,
+		[this](std::size_t const begin, std::size_t const end) {
+			for (auto i = begin; i < end; ++i) {
+				m_instance_data[i] = m_instances[i].model_matrix();
+				m_instance_textures[i] = instance_texture(i);
+				auto const* sprite = instance_sprite(i);
+				m_instance_uvs[i] =
+					sprite ? glm::vec4{sprite->uv_min,
+									   sprite->uv_max - sprite->uv_min}
+						   : glm::vec4{0.0f, 0.0f, 1.0f, 1.0f};
+			}
+		});
 	// can't use bit_cast anymore, reinterpret data as a byte array instead.
 	auto const span = std::span{m_instance_data};
 	void* data = span.data();
 	auto const bytes =
 		std::span{static_cast<std::byte const*>(data), span.size_bytes()};
-	m_instance_ssbo->write_at(m_frame_index, bytes);
+	auto const allocation = m_frame_arena->write_storage(bytes);
+	if (!allocation) { return false; }
+	auto const index_bytes = std::as_bytes(std::span{m_instance_textures});
+	auto const indices = m_frame_arena->write_storage(index_bytes);
+	if (!indices) { return false; }
+	auto const uv_bytes = std::as_bytes(std::span{m_instance_uvs});
+	auto const uvs = m_frame_arena->write_storage(uv_bytes);
+	if (!uvs) { return false; }
+	m_dynamic_offsets[1] = allocation->offset;
+	m_dynamic_offsets[2] = indices->offset;
+	m_dynamic_offsets[3] = uvs->offset;
+	return true;
 }
 
-void App::draw(vk::CommandBuffer const command_buffer) const {
+auto App::instance_texture(std::size_t const index) const -> std::uint32_t {
+	if (auto const* sprite = instance_sprite(index)) {
+		return m_atlas_slots[sprite->page];
+	}
+	// every other instance samples the streamed texture, if any.
+	if (m_streamed && index % 2 == 1) {
+		return m_streamer->get_index(*m_streamed);
+	}
+	return m_texture_index;
+}
+
+auto App::instance_sprite(std::size_t const index) const
+	-> AtlasEntry const* {
+	// every other instance samples a sprite, unless a texture is streamed.
+	if (m_streamed || m_sprites.empty() || index % 2 == 0) { return nullptr; }
+	return &m_sprites[(index / 2) % m_sprites.size()];
+}
+
+void App::draw(vk::CommandBuffer const command_buffer) {
+	if (m_draw_count == 0) { return; }
 	m_shader->bind(command_buffer, m_framebuffer_size);
 	bind_descriptor_sets(command_buffer);
-	// single VBO at binding 0 at no offset.
-	command_buffer.bindVertexBuffers(0, m_vbo.get().buffer, vk::DeviceSize{});
-	// u32 indices after offset of 4 vertices.
-	command_buffer.bindIndexBuffer(m_vbo.get().buffer, 4 * sizeof(Vertex),
-								   vk::IndexType::eUint32);
-	auto const instances = static_cast<std::uint32_t>(m_instances.size());
-	// m_vbo has 6 indices.
-	command_buffer.drawIndexed(6, instances, 0, 0, 0);
-}
-
-void App::bind_descriptor_sets(vk::CommandBuffer const command_buffer) const {
-	auto writes = std::array<vk::WriteDescriptorSet, 3>{};
-	auto const& descriptor_sets = m_descriptor_sets.at(m_frame_index);
-	auto const set0 = descriptor_sets[0];
-	auto write = vk::WriteDescriptorSet{};
-	auto const view_ubo_info = m_view_ubo->descriptor_info_at(m_frame_index);
-	write.setBufferInfo(view_ubo_info)
-		.setDescriptorType(vk::DescriptorType::eUniformBuffer)
-		.setDescriptorCount(1)
-		.setDstSet(set0)
-		.setDstBinding(0);
-	writes[0] = write;
+	draw_instances(command_buffer, 0, m_draw_count);
+}
+
+void App::draw_parallel(vk::CommandBuffer const command_buffer) {
+	auto const zone = m_profiler->cpu_zone("record_secondaries");
+	auto const color_format = m_offscreen ? m_offscreen->get_format()
+										  : m_swapchain->get_format();
+	auto const record = [this](vk::CommandBuffer const secondary,
+							   std::uint32_t const first,
+							   std::uint32_t const count) {
+		// secondary Command Buffers don't inherit any state.
+		m_shader->bind(secondary, m_framebuffer_size);
+		bind_descriptor_sets(secondary);
+		draw_instances(secondary, first, count);
+	};
+	// nothing is recorded if m_draw_count is 0.
+	auto const secondaries =
+		m_recorder->record(m_frame_index, color_format, m_draw_count, record);
+	if (secondaries.empty()) { return; }
+	command_buffer.executeCommands(secondaries);
+}
+
+void App::draw_instances(vk::CommandBuffer const command_buffer,
+						 std::uint32_t const first,
+						 std::uint32_t const count) const {
+	// one bind for all meshes, each is drawn with its base offsets.
+	m_geometry->bind(command_buffer);
+	m_geometry->draw(command_buffer, m_quad, count, first);
+}
+
+void App::write_descriptor_sets() {
+	write_arena_sets(m_descriptor_sets[0], m_descriptor_sets[2]);
+	// bindless: the texture has been written into its slot.
+	if (m_bindless) { return; }
 
-	auto const set1 = descriptor_sets[1];
+	auto const set1 = m_descriptor_sets[1];
 	auto const image_info = m_texture->descriptor_info();
+	auto write = vk::WriteDescriptorSet{};
 	write.setImageInfo(image_info)
 		.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
 		.setDescriptorCount(1)
 		.setDstSet(set1)
 		.setDstBinding(0);
-	writes[1] = write;
+	m_device->updateDescriptorSets(write, {});
+}
 
-	auto const set2 = descriptor_sets[2];
-	auto const instance_ssbo_info =
-		m_instance_ssbo->descriptor_info_at(m_frame_index);
+void App::write_arena_sets(vk::DescriptorSet const set0,
+						   vk::DescriptorSet const set2) const {
+	auto writes = std::array<vk::WriteDescriptorSet, 4>{};
+	auto write = vk::WriteDescriptorSet{};
+	auto const view_ubo_info =
+		m_frame_arena->descriptor_info(sizeof(glm::mat4));
+	write.setBufferInfo(view_ubo_info)
+		.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic)
+		.setDescriptorCount(1)
+		.setDstSet(set0)
+		.setDstBinding(0);
+	writes[0] = write;
+
+	// the instance SSBOs cover a frame's whole region: their sizes are only
+	// bounded by the arena's capacity.
+	auto const instance_ssbo_info = m_frame_arena->descriptor_info();
 	write.setBufferInfo(instance_ssbo_info)
-		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+		.setDescriptorType(vk::DescriptorType::eStorageBufferDynamic)
 		.setDescriptorCount(1)
 		.setDstSet(set2)
 		.setDstBinding(0);
+	writes[1] = write;
+
+	write.setDstBinding(1);
 	writes[2] = write;
+	write.setDstBinding(2);
+	writes[3] = write;
 
 	m_device->updateDescriptorSets(writes, {});
+}
+
+void App::replace_arena_sets() {
+	auto allocate_info = vk::DescriptorSetAllocateInfo{};
+	auto const set_layouts =
+		std::array{m_set_layout_views[0], m_set_layout_views[2]};
+	allocate_info.setDescriptorPool(*m_descriptor_pool)
+		.setSetLayouts(set_layouts);
+	auto const sets = m_device->allocateDescriptorSets(allocate_info);
+	write_arena_sets(sets[0], sets[1]);
+
+	auto const old_sets =
+		std::array{std::exchange(m_descriptor_sets[0], sets[0]),
+				   std::exchange(m_descriptor_sets[2], sets[1])};
+	for (auto const old_set : old_sets) {
+		m_deferred.release(vk::UniqueDescriptorSet{
+			old_set, {*m_device, *m_descriptor_pool}});
+	}
+}
+
+void App::replace_texture_set() {
+	if (m_bindless) {
+		auto const index = m_bindless->add(m_texture->descriptor_info());
+		if (!index) {
+			throw std::runtime_error{"Out of bindless texture slots"};
+		}
+		// the frame being recorded may still sample the old slot.
+		m_bindless->remove(std::exchange(m_texture_index, *index),
+						   m_frame_count + 1);
+		return;
+	}
+	auto allocate_info = vk::DescriptorSetAllocateInfo{};
+	allocate_info.setDescriptorPool(*m_descriptor_pool)
+		.setSetLayouts(m_set_layout_views[1]);
+	auto const set1 = m_device->allocateDescriptorSets(allocate_info).front();
+	auto const image_info = m_texture->descriptor_info();
+	auto write = vk::WriteDescriptorSet{};
+	write.setImageInfo(image_info)
+		.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+		.setDescriptorCount(1)
+		.setDstSet(set1)
+		.setDstBinding(0);
+	m_device->updateDescriptorSets(write, {});
 
+	auto const old_set = std::exchange(m_descriptor_sets[1], set1);
+	m_deferred.release(vk::UniqueDescriptorSet{
+		old_set, {*m_device, *m_descriptor_pool}});
+}
+
+void App::bind_descriptor_sets(vk::CommandBuffer const command_buffer) {
+	// also recorded on worker threads: zones are submitted thread-safely.
+	auto const zone = m_profiler->cpu_zone("bind_descriptor_sets");
+	auto sets = std::array{m_descriptor_sets[0], m_descriptor_sets[1],
+						   m_descriptor_sets[2]};
+	// the fallback's set until the streamed texture is resident (bindless:
+	// selected per instance instead).
+	if (m_streamed && !m_bindless) {
+		sets[1] = m_streamer->get_set(*m_streamed);
+	}
+	// dynamic offsets are consumed in set order.
 	command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-									  *m_pipeline_layout, 0, descriptor_sets,
-									  {});
+									  *m_pipeline_layout, 0, sets,
+									  m_dynamic_offsets);
 }
 } // namespace lvk
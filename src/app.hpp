@@ -1,23 +1,69 @@
 #pragma once
-#include <command_block.hpp>
+#include <async_uploader.hpp>
+#include <bindless_textures.hpp>
 #include <dear_imgui.hpp>
-#include <descriptor_buffer.hpp>
+#include <deferred_queue.hpp>
+#include <defragmenter.hpp>
+#include <frame_arena.hpp>
+#include <geometry_pool.hpp>
 #include <gpu.hpp>
+#include <job_system.hpp>
+#include <memory_telemetry.hpp>
+#include <offscreen_ring.hpp>
+#include <parallel_recorder.hpp>
+#include <profiler.hpp>
 #include <resource_buffering.hpp>
 #include <scoped_waiter.hpp>
 #include <shader_program.hpp>
 #include <swapchain.hpp>
 #include <texture.hpp>
+#include <texture_atlas.hpp>
+#include <texture_streamer.hpp>
 #include <transform.hpp>
 #include <vma.hpp>
 #include <window.hpp>
+#include <chrono>
 #include <filesystem>
 
 namespace lvk {
 namespace fs = std::filesystem;
 
+struct AppCreateInfo {
+	// render into a ring of offscreen images: no window, surface or Swapchain.
+	bool headless{};
+	// number of frames to render before exiting, when headless.
+	std::uint64_t frame_count{600};
+	// size of offscreen images, when headless.
+	glm::ivec2 headless_size{1280, 720};
+	// number of virtual frames (frames in flight), clamped to
+	// [1, max_resource_buffering_v].
+	std::size_t frames_in_flight{resource_buffering_v};
+	// present mode and image count, can be changed at runtime.
+	SwapchainPolicy swapchain_policy{};
+	// Chrome trace JSON output of profiled zones, disabled if empty.
+	fs::path trace_path{};
+	// number of threads recording the scene into secondary Command Buffers,
+	// 0 records it inline into the primary.
+	std::size_t record_threads{};
+	// number of job worker threads, defaults to one less than the number of
+	// hardware threads.
+	std::optional<std::size_t> job_workers{};
+	// detailed VMA statistics JSON written at exit, disabled if empty.
+	fs::path memory_stats_path{};
+	// image file (PNG / JPEG) streamed in for the quads, which are drawn
+	// with the built-in texture if empty.
+	fs::path texture_path{};
+	// block compress the streamed texture on upload, if the GPU supports a
+	// block format.
+	bool compress_textures{};
+};
+
 class App {
   public:
+	using CreateInfo = AppCreateInfo;
+
+	explicit App(CreateInfo const& create_info) : m_create_info(create_info) {}
+
 	void run();
 
   private:
@@ -26,52 +72,95 @@ class App {
 		vk::UniqueSemaphore draw{};
 		// signalled when image is ready to be presented.
 		vk::UniqueSemaphore present{};
-		// signalled with present Semaphore, waited on before next render.
-		vk::UniqueFence drawn{};
+		// value of m_render_timeline signalled along with the present
+		// Semaphore, waited on before next render.
+		std::uint64_t drawn{};
 		// used to record rendering commands.
 		vk::CommandBuffer command_buffer{};
 	};
 
+	void load_spir_v();
 	void create_window();
 	void create_instance();
 	void create_surface();
 	void select_gpu();
 	void create_device();
 	void create_swapchain();
+	void create_offscreen_ring();
 	void create_render_sync();
+	void create_recorder();
+	void create_profiler();
 	void create_imgui();
 	void create_allocator();
+	void create_uploader();
 	void create_descriptor_pool();
+	void create_bindless();
 	void create_pipeline_layout();
 	void create_shader();
-	void create_cmd_block_pool();
 	void create_shader_resources();
 	void create_descriptor_sets();
+	void create_defragmenter();
+	void create_streamer();
+	void create_atlas();
 
 	[[nodiscard]] auto asset_path(std::string_view uri) const -> fs::path;
-	[[nodiscard]] auto create_command_block() const -> CommandBlock;
 	[[nodiscard]] auto allocate_sets() const -> std::vector<vk::DescriptorSet>;
 
 	void main_loop();
+	[[nodiscard]] auto should_close() const -> bool;
 
 	auto acquire_render_target() -> bool;
 	auto begin_frame() -> vk::CommandBuffer;
-	void transition_for_render(vk::CommandBuffer command_buffer) const;
+	[[nodiscard]] auto base_barrier() const -> vk::ImageMemoryBarrier2;
+	void transition_for_render(vk::CommandBuffer command_buffer);
 	void render(vk::CommandBuffer command_buffer);
-	void transition_for_present(vk::CommandBuffer command_buffer) const;
+	void transition_for_present(vk::CommandBuffer command_buffer);
 	void submit_and_present();
 
 	// ImGui code goes here.
 	void inspect();
-	void update_view();
-	void update_instances();
+	void inspect_swapchain();
+	// both write into the frame arena: return false if it is out of space.
+	[[nodiscard]] auto update_view() -> bool;
+	[[nodiscard]] auto update_instances() -> bool;
 	// Issue draw calls here.
-	void draw(vk::CommandBuffer command_buffer) const;
+	void draw(vk::CommandBuffer command_buffer);
+	// records the draw list in parallel, executes the secondaries.
+	void draw_parallel(vk::CommandBuffer command_buffer);
+	void draw_instances(vk::CommandBuffer command_buffer, std::uint32_t first,
+						std::uint32_t count) const;
 
-	void bind_descriptor_sets(vk::CommandBuffer command_buffer) const;
+	// descriptor sets are static: per-frame data is bound by dynamic offsets.
+	void write_descriptor_sets();
+	// writes the frame arena's descriptors into sets 0 and 2.
+	void write_arena_sets(vk::DescriptorSet set0, vk::DescriptorSet set2) const;
+	// the texture moved: writes its new view into a new set 1 (or bindless
+	// slot), the old one may still be in use by frames in flight.
+	void replace_texture_set();
+	// the frame arena's Buffer was reallocated: writes it into new sets 0 and
+	// 2, the old ones may still be in use by frames in flight.
+	void replace_arena_sets();
+	// bindless slot sampled by instance index.
+	[[nodiscard]] auto instance_texture(std::size_t index) const
+		-> std::uint32_t;
+	// atlas entry sampled by instance index, if any.
+	[[nodiscard]] auto instance_sprite(std::size_t index) const
+		-> AtlasEntry const*;
+	void bind_descriptor_sets(vk::CommandBuffer command_buffer);
 
+	CreateInfo m_create_info{};
 	fs::path m_assets_dir{};
 
+	// loaded by jobs during startup, must outlive m_jobs.
+	JobCounter m_spir_v_loaded{};
+	std::vector<std::uint32_t> m_vertex_spir_v{};
+	std::vector<std::uint32_t> m_fragment_spir_v{};
+	// bindless variants, empty if not present in assets.
+	std::vector<std::uint32_t> m_bindless_vertex_spir_v{};
+	std::vector<std::uint32_t> m_bindless_fragment_spir_v{};
+	// per-frame CPU work and startup work is fanned out across its workers.
+	std::optional<JobSystem> m_jobs{};
+
 	// the order of these RAII members is crucially important.
 	glfw::Window m_window{};
 	vk::UniqueInstance m_instance{};
@@ -80,32 +169,87 @@ class App {
 	vk::UniqueDevice m_device{};
 	vk::Queue m_queue{};		  // not an RAII member.
 	vma::Allocator m_allocator{}; // anywhere between m_device and m_shader.
+	// reports leaked allocations on destruction: must be destroyed after all
+	// resources and before m_allocator.
+	std::optional<MemoryTelemetry> m_memory{};
+	// queue of m_gpu.transfer_family, if present.
+	vk::Queue m_transfer_queue{}; // not an RAII member.
+	// uploads on m_transfer_queue (or m_queue) without blocking.
+	std::optional<AsyncUploader> m_uploader{};
+	// uploads the next render submission must wait for.
+	UploadTicket m_upload_wait{};
+	// released resources, destroyed once their frames have been drawn.
+	DeferredQueue m_deferred{};
+	// samplers shared by all textures with the same create info.
+	std::optional<SamplerCache> m_samplers{};
 
 	std::optional<Swapchain> m_swapchain{};
+	// applied after the current frame has been presented.
+	std::optional<SwapchainPolicy> m_pending_policy{};
+	// latest framebuffer size while resizing, and when it was last changed.
+	glm::ivec2 m_resize_size{};
+	std::chrono::steady_clock::time_point m_resize_time{};
+	// used instead of m_swapchain when headless.
+	std::optional<OffscreenRing> m_offscreen{};
 	// command pool for all render Command Buffers.
 	vk::UniqueCommandPool m_render_cmd_pool{};
-	// command pool for all Command Blocks.
-	vk::UniqueCommandPool m_cmd_block_pool{};
 	// Sync and Command Buffer for virtual frames.
 	Buffered<RenderSync> m_render_sync{};
+	// records the scene on worker threads, if record_threads > 0.
+	std::optional<ParallelRecorder> m_recorder{};
+	// timeline Semaphore signalled with the number of frames drawn so far.
+	vk::UniqueSemaphore m_render_timeline{};
 	// Current virtual frame index.
 	std::size_t m_frame_index{};
+	// Total number of frames submitted, the value of m_render_timeline once
+	// they have all been drawn.
+	std::uint64_t m_frame_count{};
+	// CPU zones and per virtual frame GPU timestamps.
+	std::optional<Profiler> m_profiler{};
 
 	std::optional<DearImGui> m_imgui{};
 
 	vk::UniqueDescriptorPool m_descriptor_pool{};
+	// set 1 when the GPU supports descriptor indexing and the bindless
+	// shaders are present: one texture array indexed per instance.
+	std::optional<BindlessTextures> m_bindless{};
 	std::vector<vk::UniqueDescriptorSetLayout> m_set_layouts{};
 	std::vector<vk::DescriptorSetLayout> m_set_layout_views{};
 	vk::UniquePipelineLayout m_pipeline_layout{};
 
 	std::optional<ShaderProgram> m_shader{};
 
-	vma::Buffer m_vbo{};
-	std::optional<DescriptorBuffer> m_view_ubo{};
+	// vertices and indices of all meshes.
+	std::optional<GeometryPool> m_geometry{};
+	GeometryHandle m_quad{};
 	std::optional<Texture> m_texture{};
+	// slot of m_texture, when bindless.
+	std::uint32_t m_texture_index{};
+	// streams texture_path in, bound to set 1 instead of m_texture if set.
+	std::optional<TextureStreamer> m_streamer{};
+	std::optional<TextureHandle> m_streamed{};
+	// packs small sprites into a few pages, when bindless: instances sample
+	// their page's slot with a UV offset / scale.
+	std::optional<TextureAtlas> m_atlas{};
+	// bindless slot of each atlas page.
+	std::vector<std::uint32_t> m_atlas_slots{};
+	std::vector<AtlasEntry> m_sprites{};
 	std::vector<glm::mat4> m_instance_data{}; // model matrices.
-	std::optional<DescriptorBuffer> m_instance_ssbo{};
-	Buffered<std::vector<vk::DescriptorSet>> m_descriptor_sets{};
+	// bindless texture slot of each instance.
+	std::vector<std::uint32_t> m_instance_textures{};
+	// UV offset (xy) and scale (zw) of each instance, within its texture.
+	std::vector<glm::vec4> m_instance_uvs{};
+	// view UBO and instance SSBO of each frame are allocated from here.
+	std::optional<FrameArena> m_frame_arena{};
+	// dynamic offsets of the view UBO (set 0), and instance, texture index
+	// and UV SSBOs (set 2).
+	std::array<std::uint32_t, 4> m_dynamic_offsets{};
+	// instances whose data was written this frame: 0 skips the scene.
+	std::uint32_t m_draw_count{};
+	std::vector<vk::DescriptorSet> m_descriptor_sets{};
+	// moves m_geometry and m_texture: declared after them to be destroyed
+	// first.
+	std::optional<Defragmenter> m_defrag{};
 
 	glm::ivec2 m_framebuffer_size{};
 	std::optional<RenderTarget> m_render_target{};
@@ -0,0 +1,377 @@
+#include <async_uploader.hpp>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <ranges>
+
+namespace lvk {
+using namespace std::chrono_literals;
+
+namespace {
+// satisfies copyBufferToImage offset requirements for all formats in use.
+constexpr vk::DeviceSize staging_alignment_v{16};
+
+[[nodiscard]] constexpr auto
+create_subresource_range(std::uint32_t const levels,
+						 std::uint32_t const layers) {
+	auto ret = vk::ImageSubresourceRange{};
+	ret.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(layers)
+		.setLevelCount(levels);
+	return ret;
+}
+} // namespace
+
+AsyncUploader::AsyncUploader(CreateInfo const& create_info)
+	: m_create_info(create_info) {
+	auto command_pool_ci = vk::CommandPoolCreateInfo{};
+	command_pool_ci
+		.setQueueFamilyIndex(
+			create_info.transfer_family.value_or(create_info.queue_family))
+		.setFlags(vk::CommandPoolCreateFlagBits::eTransient |
+				  vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+	m_command_pool =
+		m_create_info.device.createCommandPoolUnique(command_pool_ci);
+
+	auto semaphore_type_ci = vk::SemaphoreTypeCreateInfo{};
+	semaphore_type_ci.setSemaphoreType(vk::SemaphoreType::eTimeline);
+	auto semaphore_ci = vk::SemaphoreCreateInfo{};
+	semaphore_ci.setPNext(&semaphore_type_ci);
+	m_timeline = m_create_info.device.createSemaphoreUnique(semaphore_ci);
+
+	if (create_info.staging_capacity > 0) {
+		m_ring.emplace(create_info.allocator,
+					   create_info.transfer_family.value_or(
+						   create_info.queue_family),
+					   create_info.staging_capacity);
+	}
+}
+
+auto AsyncUploader::upload_buffer(vk::BufferUsageFlags const usage,
+								  vma::ByteSpans const& byte_spans)
+	-> BufferUpload {
+	auto batch = begin_batch();
+	auto buffer = batch.add_buffer(usage, byte_spans);
+	if (!buffer.get().buffer) { return {}; }
+	return BufferUpload{
+		.buffer = std::move(buffer),
+		.ticket = submit(std::move(batch)),
+	};
+}
+
+auto AsyncUploader::upload_image(Bitmap const& bitmap,
+								 MipSettings const& mips) -> ImageUpload {
+	auto batch = begin_batch();
+	auto image = batch.add_image(bitmap, mips);
+	if (!image.get().image) { return {}; }
+	return ImageUpload{
+		.image = std::move(image),
+		.ticket = submit(std::move(batch)),
+	};
+}
+
+auto AsyncUploader::upload_image(Ktx2 const& ktx2) -> ImageUpload {
+	auto batch = begin_batch();
+	auto image = batch.add_image(ktx2);
+	if (!image.get().image) { return {}; }
+	return ImageUpload{
+		.image = std::move(image),
+		.ticket = submit(std::move(batch)),
+	};
+}
+
+auto AsyncUploader::begin_batch() -> UploadBatch { return UploadBatch{*this}; }
+
+auto AsyncUploader::submit(UploadBatch batch) -> UploadTicket {
+	if (batch.is_empty()) { return {m_submitted}; }
+	auto command_buffer = begin();
+	record(batch, *command_buffer);
+	return submit(std::move(command_buffer), std::move(batch.m_dedicated));
+}
+
+auto AsyncUploader::record_acquires(vk::CommandBuffer const command_buffer)
+	-> UploadTicket {
+	if (!m_buffer_acquires.empty() || !m_image_acquires.empty()) {
+		auto dependency_info = vk::DependencyInfo{};
+		dependency_info.setBufferMemoryBarriers(m_buffer_acquires)
+			.setImageMemoryBarriers(m_image_acquires);
+		command_buffer.pipelineBarrier2(dependency_info);
+		m_buffer_acquires.clear();
+		m_image_acquires.clear();
+	}
+	for (auto const& job : m_pending_mips) {
+		record_mip_blits(command_buffer, job.image, job.extent, job.levels,
+						 vk::ImageLayout::eShaderReadOnlyOptimal);
+	}
+	m_pending_mips.clear();
+	// waiting on an already signalled value is free.
+	return {m_submitted};
+}
+
+void AsyncUploader::record(UploadBatch const& batch,
+						   vk::CommandBuffer const command_buffer) {
+	auto const release = m_create_info.transfer_family.has_value();
+	auto const src_family =
+		m_create_info.transfer_family.value_or(vk::QueueFamilyIgnored);
+	auto const dst_family =
+		release ? m_create_info.queue_family : vk::QueueFamilyIgnored;
+
+	auto image_barriers = std::vector<vk::ImageMemoryBarrier2>{};
+	image_barriers.reserve(batch.m_image_copies.size());
+	auto buffer_barriers = std::vector<vk::BufferMemoryBarrier2>{};
+	buffer_barriers.reserve(batch.m_buffer_copies.size());
+	auto dependency_info = vk::DependencyInfo{};
+
+	// transition all images for transfer in one barrier call.
+	for (auto const& copy : batch.m_image_copies) {
+		auto const subresource_range =
+			create_subresource_range(copy.levels, copy.layers);
+		auto barrier = vk::ImageMemoryBarrier2{};
+		barrier.setImage(copy.dst)
+			.setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+			.setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+			.setOldLayout(vk::ImageLayout::eUndefined)
+			.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSubresourceRange(subresource_range)
+			.setSrcStageMask(vk::PipelineStageFlagBits2::eTopOfPipe)
+			.setSrcAccessMask(vk::AccessFlagBits2::eNone)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+			.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+		image_barriers.push_back(barrier);
+	}
+	if (!image_barriers.empty()) {
+		dependency_info.setImageMemoryBarriers(image_barriers);
+		command_buffer.pipelineBarrier2(dependency_info);
+	}
+
+	for (auto const& copy : batch.m_buffer_copies) {
+		auto buffer_copy = vk::BufferCopy2{};
+		buffer_copy.setSrcOffset(copy.src.offset)
+			.setDstOffset(copy.dst_offset)
+			.setSize(copy.src.bytes.size());
+		auto copy_buffer_info = vk::CopyBufferInfo2{};
+		copy_buffer_info.setSrcBuffer(copy.src.buffer)
+			.setDstBuffer(copy.dst)
+			.setRegions(buffer_copy);
+		command_buffer.copyBuffer2(copy_buffer_info);
+	}
+
+	for (auto const& copy : batch.m_image_copies) {
+		auto copy_info = vk::CopyBufferToImageInfo2{};
+		copy_info.setDstImage(copy.dst)
+			.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSrcBuffer(copy.src.buffer)
+			.setRegions(copy.regions);
+		command_buffer.copyBufferToImage2(copy_info);
+	}
+
+	// blits need a graphics queue: on a transfer queue they are deferred to
+	// record_acquires(), else recorded here and the images are left in
+	// ShaderReadOnlyOptimal by record_mip_blits().
+	for (auto const [copy, barrier] :
+		 std::views::zip(batch.m_image_copies, image_barriers)) {
+		if (!copy.blit) { continue; }
+		if (release) {
+			m_pending_mips.push_back(MipJob{
+				.image = copy.dst,
+				.extent = copy.extent,
+				.levels = copy.levels,
+			});
+			continue;
+		}
+		record_mip_blits(command_buffer, copy.dst, copy.extent, copy.levels,
+						 vk::ImageLayout::eTransferDstOptimal);
+		barrier.setImage(vk::Image{});
+	}
+	std::erase_if(image_barriers, [](vk::ImageMemoryBarrier2 const& barrier) {
+		return !barrier.image;
+	});
+
+	// transition all images for sampling (and release ownership of all
+	// resources to the graphics queue family) in one barrier call.
+	// ownership transfer barriers must be specified identically on both
+	// queues, except for their stage and access masks.
+	for (auto& barrier : image_barriers) {
+		barrier.setOldLayout(barrier.newLayout)
+			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setSrcQueueFamilyIndex(src_family)
+			.setDstQueueFamilyIndex(dst_family)
+			.setSrcStageMask(barrier.dstStageMask)
+			.setSrcAccessMask(barrier.dstAccessMask)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eAllGraphics)
+			.setDstAccessMask(vk::AccessFlagBits2::eShaderSampledRead);
+	}
+	if (release) {
+		for (auto const& copy : batch.m_buffer_copies) {
+			auto barrier = vk::BufferMemoryBarrier2{};
+			// only the written range: the rest of the Buffer may be in use
+			// on the graphics queue.
+			barrier.setBuffer(copy.dst)
+				.setOffset(copy.dst_offset)
+				.setSize(copy.src.bytes.size())
+				.setSrcQueueFamilyIndex(src_family)
+				.setDstQueueFamilyIndex(dst_family)
+				.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+				.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+				.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+				.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead);
+			buffer_barriers.push_back(barrier);
+		}
+		// the acquiring halves are recorded by record_acquires().
+		for (auto barrier : buffer_barriers) {
+			barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+				.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+			m_buffer_acquires.push_back(barrier);
+		}
+		for (auto barrier : image_barriers) {
+			barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+				.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+			m_image_acquires.push_back(barrier);
+		}
+		// the releasing halves have no destination scope.
+		for (auto& barrier : buffer_barriers) {
+			barrier.setDstStageMask(vk::PipelineStageFlagBits2::eNone)
+				.setDstAccessMask(vk::AccessFlagBits2::eNone);
+		}
+		for (auto& barrier : image_barriers) {
+			barrier.setDstStageMask(vk::PipelineStageFlagBits2::eNone)
+				.setDstAccessMask(vk::AccessFlagBits2::eNone);
+		}
+	}
+	if (!image_barriers.empty() || !buffer_barriers.empty()) {
+		dependency_info.setImageMemoryBarriers(image_barriers)
+			.setBufferMemoryBarriers(buffer_barriers);
+		command_buffer.pipelineBarrier2(dependency_info);
+	}
+}
+
+void AsyncUploader::collect() {
+	if (m_in_flight.empty()) { return; }
+	auto const completed = get_completed();
+	if (m_ring) { m_ring->reclaim(completed); }
+	std::erase_if(m_in_flight, [this, completed](InFlight& in_flight) {
+		if (in_flight.value > completed) { return false; }
+		in_flight.command_buffer->reset();
+		m_free_command_buffers.push_back(std::move(in_flight.command_buffer));
+		return true;
+	});
+}
+
+auto AsyncUploader::is_complete(UploadTicket const ticket) const -> bool {
+	return get_completed() >= ticket.value;
+}
+
+auto AsyncUploader::wait(UploadTicket const ticket) const -> bool {
+	static constexpr auto timeout_v =
+		static_cast<std::uint64_t>(std::chrono::nanoseconds(30s).count());
+	auto semaphore_wi = vk::SemaphoreWaitInfo{};
+	semaphore_wi.setSemaphores(*m_timeline).setValues(ticket.value);
+	auto const result =
+		m_create_info.device.waitSemaphores(semaphore_wi, timeout_v);
+	if (result != vk::Result::eSuccess) {
+		spdlog::error("[AsyncUploader] Failed to wait for upload");
+		return false;
+	}
+	return true;
+}
+
+auto AsyncUploader::begin() -> vk::UniqueCommandBuffer {
+	auto ret = vk::UniqueCommandBuffer{};
+	if (!m_free_command_buffers.empty()) {
+		ret = std::move(m_free_command_buffers.back());
+		m_free_command_buffers.pop_back();
+		++m_stats.command_buffers_reused;
+	} else {
+		auto allocate_info = vk::CommandBufferAllocateInfo{};
+		allocate_info.setCommandPool(*m_command_pool)
+			.setCommandBufferCount(1)
+			.setLevel(vk::CommandBufferLevel::ePrimary);
+		auto command_buffers =
+			m_create_info.device.allocateCommandBuffersUnique(allocate_info);
+		ret = std::move(command_buffers.front());
+		++m_stats.command_buffers_created;
+	}
+
+	auto begin_info = vk::CommandBufferBeginInfo{};
+	begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	ret->begin(begin_info);
+	return ret;
+}
+
+auto AsyncUploader::stage(std::size_t const size) -> StagingAllocation {
+	if (m_ring && size <= m_ring->get_capacity()) {
+		m_ring->reclaim(get_completed());
+		while (true) {
+			auto const slice = m_ring->allocate(size, staging_alignment_v);
+			if (slice) {
+				++m_stats.ring;
+				return StagingAllocation{.slice = *slice};
+			}
+			// the ring is full: wait for the GPU to retire the oldest copies.
+			auto const oldest = m_ring->oldest_value();
+			if (!oldest) { break; }
+			++m_stats.ring_waits;
+			// the oldest copies may still be reading the ring.
+			if (!wait(UploadTicket{*oldest})) { break; }
+			m_ring->reclaim(*oldest);
+		}
+	}
+
+	// oversized uploads, failed waits (or no ring): dedicated staging Buffer.
+	++m_stats.dedicated;
+	auto ret = StagingAllocation{.dedicated = create_staging(size)};
+	if (ret.dedicated.get().buffer) {
+		ret.slice = StagingSlice{
+			.buffer = ret.dedicated.get().buffer,
+			.bytes = ret.dedicated.get().mapped_span(),
+		};
+	}
+	return ret;
+}
+
+auto AsyncUploader::create_staging(std::size_t const size) const
+	-> vma::Buffer {
+	auto const staging_ci = vma::BufferCreateInfo{
+		.allocator = m_create_info.allocator,
+		.usage = vk::BufferUsageFlagBits::eTransferSrc,
+		.queue_family = m_create_info.transfer_family.value_or(
+			m_create_info.queue_family),
+	};
+	return vma::create_buffer(staging_ci, vma::BufferMemoryType::Host, size);
+}
+
+auto AsyncUploader::get_completed() const -> std::uint64_t {
+	return m_create_info.device.getSemaphoreCounterValue(*m_timeline);
+}
+
+auto AsyncUploader::supports_blit(vk::Format const format) const -> bool {
+	return supports_linear_blit(
+		vma::get_physical_device(m_create_info.allocator), format);
+}
+
+auto AsyncUploader::submit(vk::UniqueCommandBuffer command_buffer,
+						   std::vector<vma::Buffer> staging) -> UploadTicket {
+	command_buffer->end();
+
+	auto const value = ++m_submitted;
+	auto submit_info = vk::SubmitInfo2{};
+	auto const command_buffer_info =
+		vk::CommandBufferSubmitInfo{*command_buffer};
+	auto signal_semaphore_info = vk::SemaphoreSubmitInfo{};
+	signal_semaphore_info.setSemaphore(*m_timeline)
+		.setValue(value)
+		.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+	submit_info.setCommandBufferInfos(command_buffer_info)
+		.setSignalSemaphoreInfos(signal_semaphore_info);
+	m_create_info.queue.submit2(submit_info);
+	if (m_ring) { m_ring->retire(value); }
+
+	// keep the Command Buffer and dedicated staging Buffers (if any) alive
+	// until the GPU is done with them.
+	m_in_flight.push_back(InFlight{
+		.command_buffer = std::move(command_buffer),
+		.staging = std::move(staging),
+		.value = value,
+	});
+	return {value};
+}
+} // namespace lvk
@@ -0,0 +1,154 @@
+#pragma once
+#include <staging_ring.hpp>
+#include <upload_batch.hpp>
+#include <vma.hpp>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lvk {
+// Timeline value of an upload's submission.
+struct UploadTicket {
+	std::uint64_t value{};
+
+	auto operator<=>(UploadTicket const&) const = default;
+};
+
+struct BufferUpload {
+	vma::Buffer buffer{};
+	UploadTicket ticket{};
+};
+
+struct ImageUpload {
+	vma::Image image{};
+	UploadTicket ticket{};
+};
+
+struct AsyncUploaderCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	// family of the queue the uploaded resources are used on.
+	std::uint32_t queue_family;
+	// transfer-only family, if the GPU has one.
+	std::optional<std::uint32_t> transfer_family;
+	// queue of transfer_family if present, else of queue_family.
+	vk::Queue queue;
+	// size of the staging ring, 0 creates a dedicated staging Buffer for
+	// every upload.
+	vk::DeviceSize staging_capacity{StagingRing::default_capacity_v};
+};
+
+struct UploadStats {
+	// uploads staged through the ring.
+	std::uint64_t ring{};
+	// uploads that needed a dedicated staging Buffer.
+	std::uint64_t dedicated{};
+	// times the ring was full and an upload waited for the GPU.
+	std::uint64_t ring_waits{};
+	// Command Buffers allocated, and reset ones taken from the free list.
+	std::uint64_t command_buffers_created{};
+	std::uint64_t command_buffers_reused{};
+};
+
+// Records uploads into their own Command Buffers and submits them without
+// waiting, signalling a timeline Semaphore. Uses a transfer-only queue when
+// available, in which case ownership of uploaded resources is released to
+// the graphics queue family, and acquired by record_acquires().
+// Not thread-safe: the upload queue is externally synchronized.
+class AsyncUploader {
+  public:
+	using CreateInfo = AsyncUploaderCreateInfo;
+
+	explicit AsyncUploader(CreateInfo const& create_info);
+
+	// returns a Device Buffer, usable on the GPU once ticket is signalled.
+	[[nodiscard]] auto upload_buffer(vk::BufferUsageFlags usage,
+									 vma::ByteSpans const& byte_spans)
+		-> BufferUpload;
+	// returns a sampled image in ShaderReadOnlyOptimal layout, usable on the
+	// GPU once ticket is signalled (and record_acquires() has been recorded).
+	[[nodiscard]] auto upload_image(Bitmap const& bitmap,
+									MipSettings const& mips = {})
+		-> ImageUpload;
+	[[nodiscard]] auto upload_image(Ktx2 const& ktx2) -> ImageUpload;
+
+	// batches many uploads into a single submission.
+	[[nodiscard]] auto begin_batch() -> UploadBatch;
+	// records and submits all uploads in batch, its resources are usable on
+	// the GPU once the returned ticket is signalled.
+	auto submit(UploadBatch batch) -> UploadTicket;
+
+	// records queue family ownership acquire barriers for all submitted
+	// uploads, followed by mip blits deferred from the transfer queue.
+	// returns the ticket the submission of command_buffer must wait for (on
+	// the timeline Semaphore) before using them.
+	[[nodiscard]] auto record_acquires(vk::CommandBuffer command_buffer)
+		-> UploadTicket;
+
+	// frees staging resources of completed uploads, and resets their Command
+	// Buffers for reuse.
+	void collect();
+
+	[[nodiscard]] auto is_complete(UploadTicket ticket) const -> bool;
+	// blocks the calling thread until ticket is signalled, returns false if
+	// it was not within the timeout (or the device was lost).
+	auto wait(UploadTicket ticket) const -> bool;
+
+	[[nodiscard]] auto get_allocator() const -> VmaAllocator {
+		return m_create_info.allocator;
+	}
+	[[nodiscard]] auto get_timeline() const -> vk::Semaphore {
+		return *m_timeline;
+	}
+	[[nodiscard]] auto get_submitted() const -> UploadTicket {
+		return {m_submitted};
+	}
+	[[nodiscard]] auto has_transfer_queue() const -> bool {
+		return m_create_info.transfer_family.has_value();
+	}
+	[[nodiscard]] auto get_stats() const -> UploadStats const& {
+		return m_stats;
+	}
+
+  private:
+	// image whose levels are blitted on the graphics queue.
+	struct MipJob {
+		vk::Image image{};
+		vk::Extent2D extent{};
+		std::uint32_t levels{};
+	};
+
+	struct InFlight {
+		vk::UniqueCommandBuffer command_buffer{};
+		std::vector<vma::Buffer> staging{};
+		std::uint64_t value{};
+	};
+
+	[[nodiscard]] auto begin() -> vk::UniqueCommandBuffer;
+	void record(UploadBatch const& batch, vk::CommandBuffer command_buffer);
+	[[nodiscard]] auto stage(std::size_t size) -> StagingAllocation;
+	[[nodiscard]] auto create_staging(std::size_t size) const -> vma::Buffer;
+	[[nodiscard]] auto get_completed() const -> std::uint64_t;
+	[[nodiscard]] auto supports_blit(vk::Format format) const -> bool;
+	auto submit(vk::UniqueCommandBuffer command_buffer,
+				std::vector<vma::Buffer> staging) -> UploadTicket;
+
+	CreateInfo m_create_info{};
+	vk::UniqueCommandPool m_command_pool{};
+	vk::UniqueSemaphore m_timeline{};
+	std::uint64_t m_submitted{};
+
+	std::optional<StagingRing> m_ring{};
+	UploadStats m_stats{};
+	std::vector<InFlight> m_in_flight{};
+	// reset Command Buffers of completed uploads.
+	std::vector<vk::UniqueCommandBuffer> m_free_command_buffers{};
+	// ownership acquire barriers to be recorded on the graphics queue.
+	std::vector<vk::BufferMemoryBarrier2> m_buffer_acquires{};
+	std::vector<vk::ImageMemoryBarrier2> m_image_acquires{};
+	// blits need a graphics queue: recorded after the acquires.
+	std::vector<MipJob> m_pending_mips{};
+
+	friend class UploadBatch;
+};
+} // namespace lvk
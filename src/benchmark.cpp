@@ -0,0 +1,296 @@
+#include <async_uploader.hpp>
+#include <benchmark.hpp>
+#include <block_encoder.hpp>
+#include <gpu.hpp>
+#include <job_system.hpp>
+#include <skyline_packer.hpp>
+#include <spdlog/spdlog.h>
+#include <transform.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <format>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lvk {
+namespace {
+using Clock = std::chrono::steady_clock;
+using Ms = std::chrono::duration<double, std::milli>;
+
+void print(std::string const& line) {
+	std::puts(line.c_str());
+	spdlog::info("[Benchmark] {}", line);
+}
+
+// measures update_instances style work: model matrices for many transforms,
+// fanned out with parallel_for over increasing thread counts.
+void bench_jobs() {
+	static constexpr std::size_t count_v{1 << 20};
+	static constexpr std::size_t grain_v{4096};
+	static constexpr int iterations_v{20};
+
+	auto transforms = std::vector<Transform>(count_v);
+	for (auto [index, transform] : std::views::enumerate(transforms)) {
+		auto const x = static_cast<float>(index % 1024);
+		auto const y = static_cast<float>(index / 1024);
+		transform.position = {x, y};
+		transform.rotation = 0.1f * x;
+	}
+	auto matrices = std::vector<glm::mat4>(count_v);
+
+	auto thread_counts = std::vector<std::size_t>{};
+	auto const max_threads = JobSystem::default_worker_count() + 1;
+	for (auto threads = 1uz; threads < max_threads; threads *= 2) {
+		thread_counts.push_back(threads);
+	}
+	thread_counts.push_back(max_threads);
+
+	print(std::format("jobs: {} transforms, grain {}, {} iterations", count_v,
+					  grain_v, iterations_v));
+	auto baseline = Ms{};
+	for (auto const threads : thread_counts) {
+		auto jobs = JobSystem{threads - 1};
+		auto const update = [&](std::size_t const begin,
+								std::size_t const end) {
+			for (auto i = begin; i < end; ++i) {
+				matrices[i] = transforms[i].model_matrix();
+			}
+		};
+		// warm up.
+		jobs.parallel_for(count_v, grain_v, update);
+		auto const start = Clock::now();
+		for (int i = 0; i < iterations_v; ++i) {
+			jobs.parallel_for(count_v, grain_v, update);
+		}
+		auto const elapsed = Ms{Clock::now() - start} / iterations_v;
+		if (threads == 1) { baseline = elapsed; }
+		print(std::format("  threads: {:>2}  {:8.3f}ms  speed-up: {:.2f}x",
+						  threads, elapsed.count(), baseline / elapsed));
+	}
+}
+// minimal headless Vulkan context for GPU benchmarks.
+struct Context {
+	Context() {
+		VULKAN_HPP_DEFAULT_DISPATCHER.init();
+		auto app_info = vk::ApplicationInfo{};
+		app_info.setPApplicationName("Learn Vulkan Benchmark")
+			.setApiVersion(vk_version_v);
+		auto instance_ci = vk::InstanceCreateInfo{};
+		instance_ci.setPApplicationInfo(&app_info);
+		instance = vk::createInstanceUnique(instance_ci);
+		VULKAN_HPP_DEFAULT_DISPATCHER.init(*instance);
+
+		gpu = get_suitable_gpu(*instance, {});
+		static constexpr auto queue_priorities_v = std::array{1.0f};
+		auto queue_cis = std::vector<vk::DeviceQueueCreateInfo>{};
+		auto queue_ci = vk::DeviceQueueCreateInfo{};
+		queue_ci.setQueueFamilyIndex(gpu.queue_family)
+			.setQueueCount(1)
+			.setQueuePriorities(queue_priorities_v);
+		queue_cis.push_back(queue_ci);
+		if (gpu.transfer_family) {
+			queue_ci.setQueueFamilyIndex(*gpu.transfer_family);
+			queue_cis.push_back(queue_ci);
+		}
+		auto sync_feature =
+			vk::PhysicalDeviceSynchronization2Features{vk::True};
+		auto timeline_semaphore_feature =
+			vk::PhysicalDeviceTimelineSemaphoreFeatures{vk::True};
+		sync_feature.setPNext(&timeline_semaphore_feature);
+		auto device_ci = vk::DeviceCreateInfo{};
+		device_ci.setQueueCreateInfos(queue_cis).setPNext(&sync_feature);
+		device = gpu.device.createDeviceUnique(device_ci);
+		VULKAN_HPP_DEFAULT_DISPATCHER.init(*device);
+
+		queue = device->getQueue(gpu.queue_family, 0);
+		transfer_queue = gpu.transfer_family
+							 ? device->getQueue(*gpu.transfer_family, 0)
+							 : queue;
+		allocator = vma::create_allocator(*instance, gpu.device, *device);
+	}
+
+	Context(Context const&) = delete;
+	Context(Context&&) = delete;
+	auto operator=(Context const&) = delete;
+	auto operator=(Context&&) = delete;
+
+	~Context() { device->waitIdle(); }
+
+	vk::UniqueInstance instance{};
+	Gpu gpu{};
+	vk::UniqueDevice device{};
+	vk::Queue queue{};
+	vk::Queue transfer_queue{};
+	vma::Allocator allocator{};
+};
+
+// measures uploads per second with a dedicated staging Buffer per upload,
+// and with the staging ring.
+void bench_staging() {
+	static constexpr std::size_t upload_size_v{64 * 1024};
+	static constexpr int uploads_v{1024};
+
+	auto const context = Context{};
+	auto const payload = std::vector<std::byte>(upload_size_v);
+	auto const spans = std::array{std::span{payload}};
+	print(std::format("staging: {} uploads of {} KiB, transfer queue: {}",
+					  uploads_v, upload_size_v / 1024,
+					  context.gpu.transfer_family.has_value()));
+
+	auto const run = [&](std::string_view const name,
+						 vk::DeviceSize const capacity) {
+		auto const uploader_ci = AsyncUploader::CreateInfo{
+			.device = *context.device,
+			.allocator = context.allocator.get(),
+			.queue_family = context.gpu.queue_family,
+			.transfer_family = context.gpu.transfer_family,
+			.queue = context.transfer_queue,
+			.staging_capacity = capacity,
+		};
+		auto uploader = AsyncUploader{uploader_ci};
+		// destination Buffers must outlive their copies.
+		auto buffers = std::vector<vma::Buffer>{};
+		buffers.reserve(uploads_v);
+		auto const start = Clock::now();
+		for (int i = 0; i < uploads_v; ++i) {
+			auto upload = uploader.upload_buffer(
+				vk::BufferUsageFlagBits::eStorageBuffer, spans);
+			buffers.push_back(std::move(upload.buffer));
+			uploader.collect();
+		}
+		uploader.wait(uploader.get_submitted());
+		auto const elapsed = Ms{Clock::now() - start};
+		auto const per_second = uploads_v / (elapsed.count() / 1000.0);
+		auto const& stats = uploader.get_stats();
+		print(std::format("  {:<9} {:9.1f}ms  {:10.1f} uploads/s  ring: {} "
+						  "dedicated: {} ring waits: {}",
+						  name, elapsed.count(), per_second, stats.ring,
+						  stats.dedicated, stats.ring_waits));
+	};
+	run("dedicated", 0);
+	run("ring", StagingRing::default_capacity_v);
+}
+
+// measures block compression throughput and quality of each format and
+// quality setting, encoding on all threads.
+void bench_encode() {
+	static constexpr int size_v{1024};
+	static constexpr int iterations_v{3};
+
+	// smooth gradients, hard edges, noise and an alpha ramp.
+	auto pixels = std::vector<std::byte>(std::size_t{size_v * size_v * 4});
+	auto seed = 1u;
+	for (auto y = 0; y < size_v; ++y) {
+		for (auto x = 0; x < size_v; ++x) {
+			seed = seed * 1103515245u + 12345u;
+			auto const noise = static_cast<int>((seed >> 16) % 16);
+			auto const checker = ((x / 64 + y / 64) % 2) == 0;
+			auto const index = static_cast<std::size_t>(y * size_v + x) * 4;
+			pixels[index] = static_cast<std::byte>(x / 4);
+			pixels[index + 1] = static_cast<std::byte>(y / 8 + noise);
+			pixels[index + 2] = static_cast<std::byte>(checker ? 200 : 40);
+			pixels[index + 3] = static_cast<std::byte>((x + y) / 8);
+		}
+	}
+	auto const bitmap = Bitmap{.bytes = pixels, .size = {size_v, size_v}};
+
+	// over RGB, and alpha for formats that store it.
+	auto const psnr = [&](std::span<std::byte const> decoded,
+						  std::size_t const channels) {
+		auto squared_error = 0.0;
+		for (auto i = 0uz; i < pixels.size(); i += 4) {
+			for (auto c = 0uz; c < channels; ++c) {
+				auto const d = std::to_integer<int>(decoded[i + c]) -
+							   std::to_integer<int>(pixels[i + c]);
+				squared_error += d * d;
+			}
+		}
+		auto const samples =
+			static_cast<double>(pixels.size() / 4 * channels);
+		if (squared_error <= 0.0) { return 99.0; }
+		return 10.0 * std::log10(255.0 * 255.0 * samples / squared_error);
+	};
+
+	auto jobs = JobSystem{};
+	print(std::format("encode: {}x{} RGBA8, {} threads, {} iterations",
+					  size_v, size_v, jobs.get_worker_count() + 1,
+					  iterations_v));
+	static constexpr auto formats_v =
+		std::array{BlockFormat::Bc1, BlockFormat::Bc3, BlockFormat::Bc7,
+				   BlockFormat::Etc2};
+	static constexpr auto qualities_v = std::array{
+		BlockQuality::Fast, BlockQuality::Balanced, BlockQuality::High};
+	for (auto const format : formats_v) {
+		for (auto const quality : qualities_v) {
+			auto const settings =
+				BlockEncodeSettings{.quality = quality, .jobs = &jobs};
+			auto blocks = std::vector<std::byte>{};
+			auto const start = Clock::now();
+			for (int i = 0; i < iterations_v; ++i) {
+				blocks = encode_blocks(bitmap, format, settings);
+			}
+			auto const elapsed = Ms{Clock::now() - start} / iterations_v;
+			auto const megapixels = size_v * size_v / 1e6;
+			auto const decoded = decode_blocks(blocks, format, bitmap.size);
+			auto const channels = format == BlockFormat::Bc1 ? 3uz : 4uz;
+			print(std::format("  {:<4} {:<8} {:8.2f}ms  {:8.2f} MP/s  "
+							  "PSNR: {:.2f}dB",
+							  to_string(format), to_string(quality),
+							  elapsed.count(),
+							  megapixels / (elapsed.count() / 1000.0),
+							  psnr(decoded, channels)));
+		}
+	}
+}
+// measures skyline packing of many sprites into TextureAtlas pages, in
+// cells of 8 texels (4 mip levels): padded sprites of 3 to 18 cells.
+void bench_atlas() {
+	static constexpr std::uint32_t page_cells_v{256};
+	static constexpr std::size_t count_v{1 << 12};
+
+	auto sizes = std::vector<glm::uvec2>(count_v);
+	auto seed = 1u;
+	for (auto& size : sizes) {
+		seed = seed * 1103515245u + 12345u;
+		size.x = 3 + (seed >> 16) % 16;
+		seed = seed * 1103515245u + 12345u;
+		size.y = 3 + (seed >> 16) % 16;
+	}
+
+	print(std::format("atlas: {} sprites, {}x{} cell pages", count_v,
+					  page_cells_v, page_cells_v));
+	auto pages = std::vector<SkylinePacker>{};
+	auto const start = Clock::now();
+	for (auto const size : sizes) {
+		auto const fits = [size](SkylinePacker& page) {
+			return page.insert(size).has_value();
+		};
+		if (std::ranges::any_of(pages, fits)) { continue; }
+		pages.emplace_back(glm::uvec2{page_cells_v});
+		if (!fits(pages.back())) { break; }
+	}
+	auto const elapsed = Ms{Clock::now() - start};
+	auto occupancy = 0.0f;
+	for (auto const& page : pages) { occupancy += page.get_occupancy(); }
+	print(std::format("  {:8.2f}ms  {:8.2f} inserts/ms  {} pages  "
+					  "occupancy: {:.1f}%",
+					  elapsed.count(),
+					  static_cast<double>(count_v) / elapsed.count(),
+					  pages.size(),
+					  100.0f * occupancy / static_cast<float>(pages.size())));
+}
+} // namespace
+
+void run_benchmark(std::string_view const name) {
+	if (name == "jobs") { return bench_jobs(); }
+	if (name == "staging") { return bench_staging(); }
+	if (name == "encode") { return bench_encode(); }
+	if (name == "atlas") { return bench_atlas(); }
+	throw std::runtime_error{std::format("Unknown benchmark: '{}'", name)};
+}
+} // namespace lvk
@@ -0,0 +1,8 @@
+#pragma once
+#include <string_view>
+
+namespace lvk {
+// Runs a named CPU benchmark and prints its results to stdout.
+// Throws if name is not a known benchmark.
+void run_benchmark(std::string_view name);
+} // namespace lvk
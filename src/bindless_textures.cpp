@@ -0,0 +1,73 @@
+#include <bindless_textures.hpp>
+#include <cassert>
+
+namespace lvk {
+BindlessTextures::BindlessTextures(CreateInfo const& create_info)
+	: m_device(create_info.device), m_capacity(create_info.capacity) {
+	auto const binding = vk::DescriptorSetLayoutBinding{
+		0, vk::DescriptorType::eCombinedImageSampler, m_capacity,
+		vk::ShaderStageFlagBits::eFragment};
+	// slots are written while the set is bound, and while frames using
+	// other slots are pending. unwritten slots are never sampled.
+	static constexpr auto binding_flags_v =
+		vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+		vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending |
+		vk::DescriptorBindingFlagBits::ePartiallyBound;
+	auto binding_flags_ci = vk::DescriptorSetLayoutBindingFlagsCreateInfo{};
+	binding_flags_ci.setBindingFlags(binding_flags_v);
+	auto layout_ci = vk::DescriptorSetLayoutCreateInfo{};
+	layout_ci.setBindings(binding)
+		.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool)
+		.setPNext(&binding_flags_ci);
+	m_layout = m_device.createDescriptorSetLayoutUnique(layout_ci);
+
+	auto const pool_size = vk::DescriptorPoolSize{
+		vk::DescriptorType::eCombinedImageSampler, m_capacity};
+	auto pool_ci = vk::DescriptorPoolCreateInfo{};
+	pool_ci.setPoolSizes(pool_size)
+		.setMaxSets(1)
+		.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind);
+	m_pool = m_device.createDescriptorPoolUnique(pool_ci);
+
+	auto allocate_info = vk::DescriptorSetAllocateInfo{};
+	allocate_info.setDescriptorPool(*m_pool).setSetLayouts(*m_layout);
+	m_set = m_device.allocateDescriptorSets(allocate_info).front();
+
+	m_free.reserve(m_capacity);
+	for (auto index = m_capacity; index > 0; --index) {
+		m_free.push_back(index - 1);
+	}
+}
+
+auto BindlessTextures::add(vk::DescriptorImageInfo const& image_info)
+	-> std::optional<std::uint32_t> {
+	if (m_free.empty()) { return {}; }
+	auto const ret = m_free.back();
+	m_free.pop_back();
+
+	auto write = vk::WriteDescriptorSet{};
+	write.setImageInfo(image_info)
+		.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+		.setDescriptorCount(1)
+		.setDstSet(m_set)
+		.setDstBinding(0)
+		.setDstArrayElement(ret);
+	m_device.updateDescriptorSets(write, {});
+	return ret;
+}
+
+void BindlessTextures::remove(std::uint32_t const index,
+							  std::uint64_t const drawn_value) {
+	assert(index < m_capacity);
+	assert(m_retired.empty() || m_retired.back().drawn_value <= drawn_value);
+	m_retired.push_back(Retired{.index = index, .drawn_value = drawn_value});
+}
+
+void BindlessTextures::collect(std::uint64_t const completed_value) {
+	while (!m_retired.empty() &&
+		   m_retired.front().drawn_value <= completed_value) {
+		m_free.push_back(m_retired.front().index);
+		m_retired.pop_front();
+	}
+}
+} // namespace lvk
@@ -0,0 +1,65 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace lvk {
+struct BindlessTexturesCreateInfo {
+	vk::Device device;
+	// number of slots, must be within Gpu::max_bindless_textures.
+	std::uint32_t capacity{4096};
+};
+
+// One descriptor set holding a partially bound, update after bind array of
+// combined image samplers (`sampler2D textures[]` at binding 0), which
+// shaders index per instance. The set is bound once for all draws: textures
+// are written into free slots as they are added, while frames using other
+// slots are in flight.
+class BindlessTextures {
+  public:
+	using CreateInfo = BindlessTexturesCreateInfo;
+
+	explicit BindlessTextures(CreateInfo const& create_info);
+
+	// writes image_info into a free slot and returns its index, or nullopt if
+	// all slots are in use.
+	[[nodiscard]] auto add(vk::DescriptorImageInfo const& image_info)
+		-> std::optional<std::uint32_t>;
+	// the slot may still be sampled by frames up to drawn_value, it is reused
+	// once the render timeline reaches it.
+	void remove(std::uint32_t index, std::uint64_t drawn_value);
+	// frees slots removed in frames that have been drawn.
+	void collect(std::uint64_t completed_value);
+
+	[[nodiscard]] auto get_layout() const -> vk::DescriptorSetLayout {
+		return *m_layout;
+	}
+	[[nodiscard]] auto get_set() const -> vk::DescriptorSet { return m_set; }
+	[[nodiscard]] auto get_capacity() const -> std::uint32_t {
+		return m_capacity;
+	}
+	// slots in use, including removed ones not yet collected.
+	[[nodiscard]] auto get_used() const -> std::uint32_t {
+		return m_capacity - static_cast<std::uint32_t>(m_free.size());
+	}
+
+  private:
+	struct Retired {
+		std::uint32_t index{};
+		std::uint64_t drawn_value{};
+	};
+
+	vk::Device m_device{};
+	std::uint32_t m_capacity{};
+	vk::UniqueDescriptorSetLayout m_layout{};
+	vk::UniqueDescriptorPool m_pool{};
+	vk::DescriptorSet m_set{};
+
+	// popped from the back: lower indices are used first.
+	std::vector<std::uint32_t> m_free{};
+	// in the order of drawn values.
+	std::deque<Retired> m_retired{};
+};
+} // namespace lvk
@@ -0,0 +1,1163 @@
+#include <block_encoder.hpp>
+#include <job_system.hpp>
+#include <ktx2.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <ranges>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LVK_SSE2
+#endif
+
+namespace lvk {
+namespace {
+constexpr std::size_t channels_v{4};
+constexpr int block_texels_v{16};
+
+using Color = std::array<int, channels_v>;
+using ColorF = std::array<float, channels_v>;
+// texels of a 4x4 block, row-major.
+using Block = std::array<Color, block_texels_v>;
+using Indices = std::array<std::uint8_t, block_texels_v>;
+
+// interpolation end points of a block, weight 0 is lo and 1 is hi.
+struct Endpoints {
+	ColorF lo{};
+	ColorF hi{};
+};
+
+[[nodiscard]] auto load_block(Bitmap const& bitmap, int const block_x,
+							  int const block_y) -> Block {
+	auto ret = Block{};
+	auto const width = static_cast<std::size_t>(bitmap.size.x);
+	for (auto y = 0; y < 4; ++y) {
+		auto const row = static_cast<std::size_t>(
+			std::min(block_y * 4 + y, bitmap.size.y - 1));
+		for (auto x = 0; x < 4; ++x) {
+			auto const column = static_cast<std::size_t>(
+				std::min(block_x * 4 + x, bitmap.size.x - 1));
+			auto const offset = (row * width + column) * channels_v;
+			auto& texel = ret[static_cast<std::size_t>(y * 4 + x)];
+			for (auto c = 0uz; c < channels_v; ++c) {
+				texel[c] = std::to_integer<int>(bitmap.bytes[offset + c]);
+			}
+		}
+	}
+	return ret;
+}
+
+// picks the nearest palette entry for each texel, returns the total squared
+// error. alpha is ignored if !use_alpha.
+[[nodiscard]] auto select_indices(Block const& block,
+								  std::span<Color const> palette,
+								  bool const use_alpha, Indices& out) -> int {
+#if defined(LVK_SSE2)
+	// one channel of 8 texels per register, as 16-bit integers.
+	// (C arrays: attributes of __m128i are dropped as template arguments.)
+	__m128i texels[2][channels_v];
+	for (auto half = 0uz; half < 2; ++half) {
+		for (auto c = 0uz; c < channels_v; ++c) {
+			alignas(16) auto values = std::array<std::int16_t, 8>{};
+			for (auto i = 0uz; i < values.size(); ++i) {
+				values[i] = static_cast<std::int16_t>(block[half * 8 + i][c]);
+			}
+			texels[half][c] = _mm_load_si128(
+				reinterpret_cast<__m128i const*>(values.data()));
+		}
+	}
+
+	// 4 groups of 4 texels.
+	__m128i best_error[4];
+	__m128i best_index[4];
+	auto const zero = _mm_setzero_si128();
+	for (auto group = 0uz; group < 4; ++group) {
+		best_error[group] = _mm_set1_epi32(std::numeric_limits<int>::max());
+		best_index[group] = zero;
+	}
+	for (auto const [index, entry] : std::views::enumerate(palette)) {
+		auto const entry_index = _mm_set1_epi32(static_cast<int>(index));
+		auto const channel = [&entry](std::size_t const c) {
+			return _mm_set1_epi16(static_cast<std::int16_t>(entry[c]));
+		};
+		auto const update = [&](std::size_t const group, __m128i const error) {
+			auto const less = _mm_cmplt_epi32(error, best_error[group]);
+			best_error[group] =
+				_mm_or_si128(_mm_and_si128(less, error),
+							 _mm_andnot_si128(less, best_error[group]));
+			best_index[group] =
+				_mm_or_si128(_mm_and_si128(less, entry_index),
+							 _mm_andnot_si128(less, best_index[group]));
+		};
+		for (auto half = 0uz; half < 2; ++half) {
+			auto const* texel = texels[half];
+			auto const dr = _mm_sub_epi16(texel[0], channel(0));
+			auto const dg = _mm_sub_epi16(texel[1], channel(1));
+			auto const db = _mm_sub_epi16(texel[2], channel(2));
+			auto const da =
+				use_alpha ? _mm_sub_epi16(texel[3], channel(3)) : zero;
+			// dr*dr + dg*dg and db*db + da*da in 32-bit lanes.
+			auto const squared = [](__m128i const a, __m128i const b) {
+				return _mm_add_epi32(_mm_madd_epi16(a, a),
+									 _mm_madd_epi16(b, b));
+			};
+			update(half * 2, squared(_mm_unpacklo_epi16(dr, dg),
+									 _mm_unpacklo_epi16(db, da)));
+			update(half * 2 + 1, squared(_mm_unpackhi_epi16(dr, dg),
+										 _mm_unpackhi_epi16(db, da)));
+		}
+	}
+
+	alignas(16) auto errors = std::array<std::int32_t, block_texels_v>{};
+	alignas(16) auto indices = std::array<std::int32_t, block_texels_v>{};
+	for (auto group = 0uz; group < 4; ++group) {
+		_mm_store_si128(reinterpret_cast<__m128i*>(&errors[group * 4]),
+						best_error[group]);
+		_mm_store_si128(reinterpret_cast<__m128i*>(&indices[group * 4]),
+						best_index[group]);
+	}
+	auto ret = 0;
+	for (auto i = 0uz; i < out.size(); ++i) {
+		out[i] = static_cast<std::uint8_t>(indices[i]);
+		ret += errors[i];
+	}
+	return ret;
+#else
+	auto const channels = use_alpha ? channels_v : 3uz;
+	auto ret = 0;
+	for (auto const [texel, out_index] : std::views::zip(block, out)) {
+		auto best = std::numeric_limits<int>::max();
+		for (auto const [index, entry] : std::views::enumerate(palette)) {
+			auto error = 0;
+			for (auto c = 0uz; c < channels; ++c) {
+				auto const d = texel[c] - entry[c];
+				error += d * d;
+			}
+			if (error < best) {
+				best = error;
+				out_index = static_cast<std::uint8_t>(index);
+			}
+		}
+		ret += best;
+	}
+	return ret;
+#endif
+}
+
+[[nodiscard]] auto fit_endpoints(Block const& block, std::size_t const channels,
+								 BlockQuality const quality) -> Endpoints {
+	auto ret = Endpoints{};
+	ret.lo.fill(255.0f);
+	auto mean = ColorF{};
+	for (auto const& texel : block) {
+		for (auto c = 0uz; c < channels; ++c) {
+			auto const value = static_cast<float>(texel[c]);
+			ret.lo[c] = std::min(ret.lo[c], value);
+			ret.hi[c] = std::max(ret.hi[c], value);
+			mean[c] += value / block_texels_v;
+		}
+	}
+	if (quality == BlockQuality::Fast) {
+		// inset the bounding box: its corners are rarely texels.
+		for (auto c = 0uz; c < channels; ++c) {
+			auto const inset = (ret.hi[c] - ret.lo[c]) / 16.0f;
+			ret.lo[c] += inset;
+			ret.hi[c] -= inset;
+		}
+		return ret;
+	}
+
+	// principal axis: power iteration on the covariance matrix, starting
+	// from the bounding box diagonal.
+	auto covariance = std::array<ColorF, channels_v>{};
+	for (auto const& texel : block) {
+		for (auto i = 0uz; i < channels; ++i) {
+			auto const di = static_cast<float>(texel[i]) - mean[i];
+			for (auto j = 0uz; j < channels; ++j) {
+				auto const dj = static_cast<float>(texel[j]) - mean[j];
+				covariance[i][j] += di * dj;
+			}
+		}
+	}
+	auto axis = ColorF{};
+	for (auto c = 0uz; c < channels; ++c) { axis[c] = ret.hi[c] - ret.lo[c]; }
+	for (auto iteration = 0; iteration < 4; ++iteration) {
+		auto next = ColorF{};
+		auto length = 0.0f;
+		for (auto i = 0uz; i < channels; ++i) {
+			for (auto j = 0uz; j < channels; ++j) {
+				next[i] += covariance[i][j] * axis[j];
+			}
+			length = std::max(length, std::abs(next[i]));
+		}
+		if (length <= 0.0f) { break; }
+		for (auto c = 0uz; c < channels; ++c) { axis[c] = next[c] / length; }
+	}
+	auto length_squared = 0.0f;
+	for (auto c = 0uz; c < channels; ++c) {
+		length_squared += axis[c] * axis[c];
+	}
+	if (length_squared <= 0.0f) { return Endpoints{.lo = mean, .hi = mean}; }
+
+	auto t_min = std::numeric_limits<float>::max();
+	auto t_max = std::numeric_limits<float>::lowest();
+	for (auto const& texel : block) {
+		auto t = 0.0f;
+		for (auto c = 0uz; c < channels; ++c) {
+			t += (static_cast<float>(texel[c]) - mean[c]) * axis[c];
+		}
+		t_min = std::min(t_min, t);
+		t_max = std::max(t_max, t);
+	}
+	for (auto c = 0uz; c < channels; ++c) {
+		auto const scale = axis[c] / length_squared;
+		ret.lo[c] = std::clamp(mean[c] + t_min * scale, 0.0f, 255.0f);
+		ret.hi[c] = std::clamp(mean[c] + t_max * scale, 0.0f, 255.0f);
+	}
+	return ret;
+}
+
+// least squares end points for the selected indices, weights are the
+// position of each palette entry between lo and hi.
+[[nodiscard]] auto refine_endpoints(Block const& block, Indices const& indices,
+									std::span<float const> weights,
+									std::size_t const channels,
+									Endpoints const& fallback) -> Endpoints {
+	auto lo_lo = 0.0f;
+	auto hi_hi = 0.0f;
+	auto lo_hi = 0.0f;
+	auto lo_sum = ColorF{};
+	auto hi_sum = ColorF{};
+	for (auto const [texel, index] : std::views::zip(block, indices)) {
+		auto const w = weights[index];
+		lo_lo += (1.0f - w) * (1.0f - w);
+		hi_hi += w * w;
+		lo_hi += (1.0f - w) * w;
+		for (auto c = 0uz; c < channels; ++c) {
+			lo_sum[c] += (1.0f - w) * static_cast<float>(texel[c]);
+			hi_sum[c] += w * static_cast<float>(texel[c]);
+		}
+	}
+	auto const determinant = lo_lo * hi_hi - lo_hi * lo_hi;
+	if (std::abs(determinant) < 1e-6f) { return fallback; }
+	auto ret = fallback;
+	for (auto c = 0uz; c < channels; ++c) {
+		auto const lo = (lo_sum[c] * hi_hi - hi_sum[c] * lo_hi) / determinant;
+		auto const hi = (hi_sum[c] * lo_lo - lo_sum[c] * lo_hi) / determinant;
+		ret.lo[c] = std::clamp(lo, 0.0f, 255.0f);
+		ret.hi[c] = std::clamp(hi, 0.0f, 255.0f);
+	}
+	return ret;
+}
+
+// fits end points and encodes, then refines them while the error improves.
+// encode(Endpoints) returns a candidate with indices and error.
+template <typename Encode>
+[[nodiscard]] auto encode_refined(Block const& block, std::size_t channels,
+								  BlockQuality const quality,
+								  std::span<float const> weights,
+								  Encode const& encode) {
+	auto endpoints = fit_endpoints(block, channels, quality);
+	auto ret = encode(endpoints);
+	if (quality != BlockQuality::Fast) {
+		// the bounding box can beat the principal axis (eg for blocks with
+		// uncorrelated channels).
+		auto const bounds = fit_endpoints(block, channels, BlockQuality::Fast);
+		auto candidate = encode(bounds);
+		if (candidate.error < ret.error) {
+			ret = candidate;
+			endpoints = bounds;
+		}
+	}
+	auto const iterations = [quality] {
+		switch (quality) {
+		case BlockQuality::Fast: return 0;
+		case BlockQuality::Balanced: return 1;
+		case BlockQuality::High: break;
+		}
+		return 8;
+	}();
+	for (auto i = 0; i < iterations && ret.error > 0; ++i) {
+		endpoints =
+			refine_endpoints(block, ret.indices, weights, channels, endpoints);
+		auto candidate = encode(endpoints);
+		if (candidate.error >= ret.error) { break; }
+		ret = candidate;
+	}
+	return ret;
+}
+
+// [0, 255] => [0, max].
+[[nodiscard]] auto quantize(float const value, int const max) -> int {
+	auto const scaled = value * static_cast<float>(max) / 255.0f;
+	return std::clamp(static_cast<int>(std::lround(scaled)), 0, max);
+}
+
+// little-endian.
+void write_bits(std::byte* out, std::uint64_t const bits) {
+	for (auto i = 0uz; i < sizeof(bits); ++i) {
+		out[i] = static_cast<std::byte>((bits >> (8 * i)) & 0xff);
+	}
+}
+
+[[nodiscard]] auto read_bits(std::byte const* in) -> std::uint64_t {
+	auto ret = std::uint64_t{};
+	for (auto i = 0uz; i < sizeof(ret); ++i) {
+		ret |= std::to_integer<std::uint64_t>(in[i]) << (8 * i);
+	}
+	return ret;
+}
+
+// ETC blocks are big-endian.
+void write_bits_be(std::byte* out, std::uint64_t const bits) {
+	for (auto i = 0uz; i < sizeof(bits); ++i) {
+		out[i] = static_cast<std::byte>((bits >> (56 - 8 * i)) & 0xff);
+	}
+}
+
+[[nodiscard]] auto read_bits_be(std::byte const* in) -> std::uint64_t {
+	auto ret = std::uint64_t{};
+	for (auto i = 0uz; i < sizeof(ret); ++i) {
+		ret |= std::to_integer<std::uint64_t>(in[i]) << (56 - 8 * i);
+	}
+	return ret;
+}
+
+// BC1 / BC3 color.
+
+// palette entries: c0 (hi), c1 (lo), 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1.
+constexpr auto bc1_weights_v =
+	std::array{1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+struct Bc1Candidate {
+	std::uint16_t c0{};
+	std::uint16_t c1{};
+	Indices indices{};
+	int error{};
+};
+
+[[nodiscard]] auto to_565(ColorF const& color) -> std::uint16_t {
+	return static_cast<std::uint16_t>((quantize(color[0], 31) << 11) |
+									  (quantize(color[1], 63) << 5) |
+									  quantize(color[2], 31));
+}
+
+[[nodiscard]] auto from_565(std::uint16_t const value) -> Color {
+	auto const r = (value >> 11) & 31;
+	auto const g = (value >> 5) & 63;
+	auto const b = value & 31;
+	return Color{(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2),
+				 255};
+}
+
+[[nodiscard]] auto bc1_palette(Color const& p0, Color const& p1)
+	-> std::array<Color, 4> {
+	auto ret = std::array<Color, 4>{p0, p1};
+	for (auto c = 0uz; c < 3; ++c) {
+		ret[2][c] = (2 * p0[c] + p1[c]) / 3;
+		ret[3][c] = (p0[c] + 2 * p1[c]) / 3;
+	}
+	ret[2][3] = ret[3][3] = 255;
+	return ret;
+}
+
+[[nodiscard]] auto encode_bc1_color(Block const& block,
+									Endpoints const& endpoints)
+	-> Bc1Candidate {
+	auto ret = Bc1Candidate{.c0 = to_565(endpoints.hi),
+							.c1 = to_565(endpoints.lo)};
+	auto const palette = bc1_palette(from_565(ret.c0), from_565(ret.c1));
+	// equal end points select the 3 color mode: use only the first entry.
+	auto const entries = ret.c0 == ret.c1 ? 1uz : palette.size();
+	ret.error = select_indices(block, std::span{palette}.first(entries), false,
+							   ret.indices);
+	return ret;
+}
+
+void write_bc1_color(Bc1Candidate candidate, std::byte* out) {
+	// c0 > c1 selects the 4 color mode: swapping end points swaps palette
+	// entries 0 / 1 and 2 / 3.
+	if (candidate.c0 < candidate.c1) {
+		std::swap(candidate.c0, candidate.c1);
+		for (auto& index : candidate.indices) { index ^= 1; }
+	}
+	auto bits =
+		std::uint64_t{candidate.c0} | (std::uint64_t{candidate.c1} << 16);
+	for (auto const [i, index] : std::views::enumerate(candidate.indices)) {
+		bits |= std::uint64_t{index} << (32 + 2 * i);
+	}
+	write_bits(out, bits);
+}
+
+// BC3 color blocks are always in the 4 color mode, and keep decoded alpha.
+void decode_bc1_color(std::byte const* in, bool const bc3, Block& out) {
+	auto const bits = read_bits(in);
+	auto const c0 = static_cast<std::uint16_t>(bits & 0xffff);
+	auto const c1 = static_cast<std::uint16_t>((bits >> 16) & 0xffff);
+	auto palette = bc1_palette(from_565(c0), from_565(c1));
+	if (!bc3 && c0 <= c1) {
+		// 3 colors and transparent black.
+		for (auto c = 0uz; c < 3; ++c) {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+		}
+		palette[3] = {};
+	}
+	for (auto const [i, texel] : std::views::enumerate(out)) {
+		auto const alpha = texel[3];
+		texel = palette[(bits >> (32 + 2 * i)) & 3];
+		if (bc3) { texel[3] = alpha; }
+	}
+}
+
+// BC3 alpha: 8 interpolated values.
+
+[[nodiscard]] auto bc3_alpha_palette(int const a0, int const a1)
+	-> std::array<int, 8> {
+	auto ret = std::array<int, 8>{a0, a1};
+	if (a0 > a1) {
+		for (auto k = 2uz; k < 8; ++k) {
+			auto const i = static_cast<int>(k);
+			ret[k] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+		}
+	} else {
+		for (auto k = 2uz; k < 6; ++k) {
+			auto const i = static_cast<int>(k);
+			ret[k] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+		}
+		ret[7] = 255;
+	}
+	return ret;
+}
+
+void encode_bc3_alpha(Block const& block, std::byte* out) {
+	auto a_min = 255;
+	auto a_max = 0;
+	for (auto const& texel : block) {
+		a_min = std::min(a_min, texel[3]);
+		a_max = std::max(a_max, texel[3]);
+	}
+	// a0 > a1: 8 value mode (a0 == a1 decodes the same for index 0).
+	auto const palette = bc3_alpha_palette(a_max, a_min);
+	auto bits = std::uint64_t(a_max) | (std::uint64_t(a_min) << 8);
+	for (auto const [i, texel] : std::views::enumerate(block)) {
+		auto best = std::numeric_limits<int>::max();
+		auto best_index = 0uz;
+		for (auto const [index, value] : std::views::enumerate(palette)) {
+			auto const error = std::abs(texel[3] - value);
+			if (error < best) {
+				best = error;
+				best_index = static_cast<std::size_t>(index);
+			}
+		}
+		bits |= std::uint64_t{best_index} << (16 + 3 * i);
+	}
+	write_bits(out, bits);
+}
+
+void decode_bc3_alpha(std::byte const* in, Block& out) {
+	auto const bits = read_bits(in);
+	auto const a0 = static_cast<int>(bits & 0xff);
+	auto const a1 = static_cast<int>((bits >> 8) & 0xff);
+	auto const palette = bc3_alpha_palette(a0, a1);
+	for (auto const [i, texel] : std::views::enumerate(out)) {
+		texel[3] = palette[(bits >> (16 + 3 * i)) & 7];
+	}
+}
+
+// BC7 mode 6: RGBA end points of 7 bits and a shared (per end point) p-bit,
+// 4-bit indices.
+
+constexpr auto bc7_weights_v =
+	std::array{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+constexpr auto bc7_weights_f_v = [] {
+	auto ret = std::array<float, bc7_weights_v.size()>{};
+	for (auto i = 0uz; i < ret.size(); ++i) {
+		ret[i] = static_cast<float>(bc7_weights_v[i]) / 64.0f;
+	}
+	return ret;
+}();
+
+struct Bc7Candidate {
+	// 8-bit values: 7 bits followed by the p-bit.
+	std::array<Color, 2> endpoints{};
+	Indices indices{};
+	int error{};
+};
+
+[[nodiscard]] auto quantize_bc7(ColorF const& color) -> Color {
+	auto ret = Color{};
+	auto best = std::numeric_limits<float>::max();
+	for (auto p = 0; p < 2; ++p) {
+		auto candidate = Color{};
+		auto error = 0.0f;
+		for (auto c = 0uz; c < channels_v; ++c) {
+			auto const scaled = (color[c] - static_cast<float>(p)) / 2.0f;
+			auto const q =
+				std::clamp(static_cast<int>(std::lround(scaled)), 0, 127);
+			candidate[c] = (q << 1) | p;
+			auto const d = static_cast<float>(candidate[c]) - color[c];
+			error += d * d;
+		}
+		if (error < best) {
+			best = error;
+			ret = candidate;
+		}
+	}
+	return ret;
+}
+
+[[nodiscard]] auto bc7_palette(std::array<Color, 2> const& endpoints)
+	-> std::array<Color, bc7_weights_v.size()> {
+	auto ret = std::array<Color, bc7_weights_v.size()>{};
+	for (auto const [entry, weight] : std::views::zip(ret, bc7_weights_v)) {
+		for (auto c = 0uz; c < channels_v; ++c) {
+			entry[c] = ((64 - weight) * endpoints[0][c] +
+						weight * endpoints[1][c] + 32) >>
+					   6;
+		}
+	}
+	return ret;
+}
+
+[[nodiscard]] auto encode_bc7(Block const& block, Endpoints const& endpoints)
+	-> Bc7Candidate {
+	auto ret = Bc7Candidate{
+		.endpoints = {quantize_bc7(endpoints.lo), quantize_bc7(endpoints.hi)},
+	};
+	auto const palette = bc7_palette(ret.endpoints);
+	ret.error = select_indices(block, palette, true, ret.indices);
+	return ret;
+}
+
+// appends bits to a 128-bit little-endian block.
+class BitWriter {
+  public:
+	explicit BitWriter(std::byte* out) : m_out(out) {
+		std::fill_n(m_out, 16, std::byte{});
+	}
+
+	void write(std::uint32_t const value, int const count) {
+		for (auto i = 0; i < count; ++i, ++m_position) {
+			if (((value >> i) & 1) == 0) { continue; }
+			m_out[m_position / 8] |= std::byte{1} << (m_position % 8);
+		}
+	}
+
+  private:
+	std::byte* m_out{};
+	int m_position{};
+};
+
+[[nodiscard]] auto read_field(std::byte const* in, int& position,
+							  int const count) -> int {
+	auto ret = 0;
+	for (auto i = 0; i < count; ++i, ++position) {
+		auto const bit = std::to_integer<int>(in[position / 8] >>
+											  (position % 8)) &
+						 1;
+		ret |= bit << i;
+	}
+	return ret;
+}
+
+void write_bc7(Bc7Candidate candidate, std::byte* out) {
+	// the anchor (first) index has an implicit 0 MSB: swapping end points
+	// reverses the palette.
+	if ((candidate.indices[0] & 8) != 0) {
+		std::swap(candidate.endpoints[0], candidate.endpoints[1]);
+		for (auto& index : candidate.indices) {
+			index = static_cast<std::uint8_t>(15 - index);
+		}
+	}
+	auto writer = BitWriter{out};
+	// mode 6: 6 zero bits followed by a one.
+	writer.write(1u << 6, 7);
+	for (auto c = 0uz; c < channels_v; ++c) {
+		for (auto const& endpoint : candidate.endpoints) {
+			writer.write(static_cast<std::uint32_t>(endpoint[c] >> 1), 7);
+		}
+	}
+	for (auto const& endpoint : candidate.endpoints) {
+		writer.write(static_cast<std::uint32_t>(endpoint[0] & 1), 1);
+	}
+	for (auto const [i, index] : std::views::enumerate(candidate.indices)) {
+		writer.write(index, i == 0 ? 3 : 4);
+	}
+}
+
+void decode_bc7(std::byte const* in, Block& out) {
+	auto position = 0;
+	if (read_field(in, position, 7) != (1 << 6)) {
+		// not mode 6: not written by encode_blocks().
+		out.fill(Color{255, 0, 255, 255});
+		return;
+	}
+	auto endpoints = std::array<Color, 2>{};
+	for (auto c = 0uz; c < channels_v; ++c) {
+		for (auto& endpoint : endpoints) {
+			endpoint[c] = read_field(in, position, 7) << 1;
+		}
+	}
+	for (auto& endpoint : endpoints) {
+		auto const p = read_field(in, position, 1);
+		for (auto& value : endpoint) { value |= p; }
+	}
+	auto const palette = bc7_palette(endpoints);
+	for (auto i = 0uz; i < out.size(); ++i) {
+		auto const index = read_field(in, position, i == 0 ? 3 : 4);
+		out[i] = palette[static_cast<std::size_t>(index)];
+	}
+}
+
+// ETC2 RGBA8: EAC alpha followed by ETC1 (individual / differential mode)
+// color. Texels are indexed column-major.
+
+constexpr auto etc1_tables_v = std::array<std::array<int, 2>, 8>{{
+	{2, 8},
+	{5, 17},
+	{9, 29},
+	{13, 42},
+	{18, 60},
+	{24, 80},
+	{33, 106},
+	{47, 183},
+}};
+
+// modifiers in index order: (msb, lsb) of 00, 01, 10, 11.
+[[nodiscard]] constexpr auto etc1_modifier(std::size_t const table,
+										   std::size_t const index) {
+	auto const& entry = etc1_tables_v[table];
+	auto const magnitude = entry[index & 1];
+	return index >= 2 ? -magnitude : magnitude;
+}
+
+[[nodiscard]] constexpr auto column_major(std::size_t const row_major) {
+	return (row_major % 4) * 4 + row_major / 4;
+}
+
+// texels (row-major) of sub-block half for flip.
+[[nodiscard]] constexpr auto in_sub_block(std::size_t const texel,
+										  bool const flip,
+										  std::size_t const half) {
+	auto const coordinate = flip ? texel / 4 : texel % 4;
+	return coordinate / 2 == half;
+}
+
+// texels (row-major) of each sub-block, indexed by [flip][half].
+constexpr auto sub_block_texels_v = [] {
+	auto ret = std::array<std::array<std::array<std::size_t, 8>, 2>, 2>{};
+	for (auto const flip : {false, true}) {
+		auto counts = std::array<std::size_t, 2>{};
+		for (auto texel = 0uz; texel < Block{}.size(); ++texel) {
+			auto const half = in_sub_block(texel, flip, 0) ? 0uz : 1uz;
+			ret[flip ? 1 : 0][half][counts[half]++] = texel;
+		}
+	}
+	return ret;
+}();
+
+struct EtcSubBlock {
+	std::size_t table{};
+	int error{};
+};
+
+// best table for the texels of a sub-block with base, indices are written
+// into (row-major) indices.
+[[nodiscard]] auto fit_etc1_table(Block const& block, bool const flip,
+								  std::size_t const half, Color const& base,
+								  Indices& indices) -> EtcSubBlock {
+	auto const& texels = sub_block_texels_v[flip ? 1 : 0][half];
+	auto ret = EtcSubBlock{.error = std::numeric_limits<int>::max()};
+	auto table_indices = Indices{};
+	for (auto table = 0uz; table < etc1_tables_v.size(); ++table) {
+		// the 4 colors of this table.
+		auto palette = std::array<Color, 4>{};
+		for (auto const [index, color] : std::views::enumerate(palette)) {
+			auto const modifier =
+				etc1_modifier(table, static_cast<std::size_t>(index));
+			for (auto c = 0uz; c < 3; ++c) {
+				color[c] = std::clamp(base[c] + modifier, 0, 255);
+			}
+		}
+		auto error = 0;
+		for (auto const texel : texels) {
+			auto best = std::numeric_limits<int>::max();
+			for (auto const [index, color] : std::views::enumerate(palette)) {
+				auto texel_error = 0;
+				for (auto c = 0uz; c < 3; ++c) {
+					auto const d = color[c] - block[texel][c];
+					texel_error += d * d;
+				}
+				if (texel_error < best) {
+					best = texel_error;
+					table_indices[texel] = static_cast<std::uint8_t>(index);
+				}
+			}
+			error += best;
+			// no better than the best table so far.
+			if (error >= ret.error) { break; }
+		}
+		if (error < ret.error) {
+			ret = EtcSubBlock{.table = table, .error = error};
+			for (auto const texel : texels) {
+				indices[texel] = table_indices[texel];
+			}
+		}
+	}
+	return ret;
+}
+
+[[nodiscard]] constexpr auto expand_etc(int const value, int const bits) {
+	return bits == 4 ? value * 17 : (value << 3) | (value >> 2);
+}
+
+struct EtcCandidate {
+	std::uint64_t bits{};
+	int error{std::numeric_limits<int>::max()};
+};
+
+[[nodiscard]] auto encode_etc1(Block const& block, BlockQuality const quality)
+	-> std::uint64_t {
+	// luminance shifts of the average colors tried per sub-block.
+	auto const max_shift = static_cast<int>(quality);
+	auto ret = EtcCandidate{};
+	for (auto const flip : {false, true}) {
+		auto averages = std::array<ColorF, 2>{};
+		for (auto texel = 0uz; texel < block.size(); ++texel) {
+			auto const half = in_sub_block(texel, flip, 0) ? 0uz : 1uz;
+			for (auto c = 0uz; c < 3; ++c) {
+				averages[half][c] += static_cast<float>(block[texel][c]) / 8.0f;
+			}
+		}
+
+		auto quantized = std::array<Color, 2>{};
+		auto differential = true;
+		for (auto c = 0uz; c < 3; ++c) {
+			quantized[0][c] = quantize(averages[0][c], 31);
+			quantized[1][c] = quantize(averages[1][c], 31);
+			auto const delta = quantized[1][c] - quantized[0][c];
+			differential = differential && delta >= -4 && delta <= 3;
+		}
+		auto const bits = differential ? 5 : 4;
+		if (!differential) {
+			for (auto half = 0uz; half < 2; ++half) {
+				for (auto c = 0uz; c < 3; ++c) {
+					quantized[half][c] = quantize(averages[half][c], 15);
+				}
+			}
+		}
+
+		auto const max_value = (1 << bits) - 1;
+		auto indices = Indices{};
+		auto tables = std::array<std::size_t, 2>{};
+		auto error = 0;
+		for (auto half = 0uz; half < 2; ++half) {
+			auto best = EtcSubBlock{.error = std::numeric_limits<int>::max()};
+			auto best_base = quantized[half];
+			auto best_indices = indices;
+			for (auto shift = -max_shift; shift <= max_shift; ++shift) {
+				auto base = quantized[half];
+				for (auto c = 0uz; c < 3; ++c) {
+					base[c] = std::clamp(base[c] + shift, 0, max_value);
+				}
+				if (differential) {
+					// the delta to the other sub-block must remain in range.
+					auto const& other = quantized[1 - half];
+					auto in_range = true;
+					for (auto c = 0uz; c < 3; ++c) {
+						auto const delta =
+							half == 0 ? other[c] - base[c] : base[c] - other[c];
+						in_range = in_range && delta >= -4 && delta <= 3;
+					}
+					if (!in_range) { continue; }
+				}
+				auto expanded = Color{};
+				for (auto c = 0uz; c < 3; ++c) {
+					expanded[c] = expand_etc(base[c], bits);
+				}
+				auto candidate_indices = indices;
+				auto const candidate = fit_etc1_table(
+					block, flip, half, expanded, candidate_indices);
+				if (candidate.error < best.error) {
+					best = candidate;
+					best_base = base;
+					best_indices = candidate_indices;
+				}
+			}
+			quantized[half] = best_base;
+			indices = best_indices;
+			tables[half] = best.table;
+			error += best.error;
+		}
+		if (error >= ret.error) { continue; }
+
+		auto candidate = std::uint64_t{};
+		for (auto c = 0uz; c < 3; ++c) {
+			auto const shift = 56 - 8 * c;
+			auto const byte =
+				differential
+					? (quantized[0][c] << 3) |
+						  ((quantized[1][c] - quantized[0][c]) & 7)
+					: (quantized[0][c] << 4) | quantized[1][c];
+			candidate |= std::uint64_t(byte) << shift;
+		}
+		candidate |= std::uint64_t(tables[0]) << 37;
+		candidate |= std::uint64_t(tables[1]) << 34;
+		candidate |= std::uint64_t(differential ? 1 : 0) << 33;
+		candidate |= std::uint64_t(flip ? 1 : 0) << 32;
+		for (auto texel = 0uz; texel < block.size(); ++texel) {
+			auto const bit = column_major(texel);
+			candidate |= std::uint64_t(indices[texel] >> 1) << (16 + bit);
+			candidate |= std::uint64_t(indices[texel] & 1) << bit;
+		}
+		ret = EtcCandidate{.bits = candidate, .error = error};
+	}
+	return ret.bits;
+}
+
+void decode_etc1(std::uint64_t const bits, Block& out) {
+	auto const differential = ((bits >> 33) & 1) != 0;
+	auto const flip = ((bits >> 32) & 1) != 0;
+	auto bases = std::array<Color, 2>{};
+	for (auto c = 0uz; c < 3; ++c) {
+		auto const byte = static_cast<int>((bits >> (56 - 8 * c)) & 0xff);
+		if (differential) {
+			auto const first = byte >> 3;
+			// sign extend the 3-bit delta.
+			auto const delta = ((byte & 7) ^ 4) - 4;
+			bases[0][c] = expand_etc(first, 5);
+			bases[1][c] = expand_etc(first + delta, 5);
+		} else {
+			bases[0][c] = expand_etc(byte >> 4, 4);
+			bases[1][c] = expand_etc(byte & 15, 4);
+		}
+	}
+	auto const tables = std::array{static_cast<std::size_t>((bits >> 37) & 7),
+								   static_cast<std::size_t>((bits >> 34) & 7)};
+	for (auto texel = 0uz; texel < out.size(); ++texel) {
+		auto const half = in_sub_block(texel, flip, 0) ? 0uz : 1uz;
+		auto const bit = column_major(texel);
+		auto const index = static_cast<std::size_t>(
+			(((bits >> (16 + bit)) & 1) << 1) | ((bits >> bit) & 1));
+		auto const modifier = etc1_modifier(tables[half], index);
+		for (auto c = 0uz; c < 3; ++c) {
+			out[texel][c] = std::clamp(bases[half][c] + modifier, 0, 255);
+		}
+	}
+}
+
+constexpr auto eac_tables_v = std::array<std::array<int, 8>, 16>{{
+	{-3, -6, -9, -15, 2, 5, 8, 14},
+	{-3, -7, -10, -13, 2, 6, 9, 12},
+	{-2, -5, -8, -13, 1, 4, 7, 12},
+	{-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11},
+	{-3, -7, -9, -11, 2, 6, 8, 10},
+	{-4, -7, -8, -11, 3, 6, 7, 10},
+	{-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7, 9},
+	{-2, -5, -8, -10, 1, 4, 7, 9},
+	{-2, -4, -8, -10, 1, 3, 7, 9},
+	{-2, -5, -7, -10, 1, 4, 6, 9},
+	{-3, -4, -7, -10, 2, 3, 6, 9},
+	{-1, -2, -3, -10, 0, 1, 2, 9},
+	{-4, -6, -8, -9, 3, 5, 7, 8},
+	{-3, -5, -7, -9, 2, 4, 6, 8},
+}};
+
+[[nodiscard]] auto encode_eac_alpha(Block const& block,
+									BlockQuality const quality)
+	-> std::uint64_t {
+	auto a_min = 255;
+	auto a_max = 0;
+	for (auto const& texel : block) {
+		a_min = std::min(a_min, texel[3]);
+		a_max = std::max(a_max, texel[3]);
+	}
+	// table 13 has a 0 modifier (index 4).
+	if (a_min == a_max) {
+		auto ret = std::uint64_t(a_min) << 56 | std::uint64_t{1} << 52 |
+				   std::uint64_t{13} << 48;
+		for (auto texel = 0; texel < block_texels_v; ++texel) {
+			ret |= std::uint64_t{4} << (45 - 3 * texel);
+		}
+		return ret;
+	}
+
+	// base and multiplier offsets tried around the fitted values.
+	auto const search = quality == BlockQuality::High ? 1 : 0;
+	auto ret = EtcCandidate{};
+	for (auto table = 0uz; table < eac_tables_v.size(); ++table) {
+		auto const& modifiers = eac_tables_v[table];
+		auto const [lowest, highest] = std::ranges::minmax(modifiers);
+		auto const fitted_multiplier =
+			std::lround(static_cast<float>(a_max - a_min) /
+						static_cast<float>(highest - lowest));
+		for (auto m = -search; m <= search; ++m) {
+			auto const multiplier =
+				std::clamp(static_cast<int>(fitted_multiplier) + m, 1, 15);
+			auto const fitted_base = a_min - lowest * multiplier;
+			for (auto b = -search; b <= search; ++b) {
+				auto const base = std::clamp(fitted_base + b, 0, 255);
+				auto bits = std::uint64_t(base) << 56 |
+							std::uint64_t(multiplier) << 52 |
+							std::uint64_t(table) << 48;
+				auto error = 0;
+				for (auto texel = 0uz; texel < block.size(); ++texel) {
+					auto best = std::numeric_limits<int>::max();
+					auto best_index = 0uz;
+					for (auto const [index, modifier] :
+						 std::views::enumerate(modifiers)) {
+						auto const value =
+							std::clamp(base + modifier * multiplier, 0, 255);
+						auto const d = std::abs(value - block[texel][3]);
+						if (d < best) {
+							best = d;
+							best_index = static_cast<std::size_t>(index);
+						}
+					}
+					error += best * best;
+					bits |= std::uint64_t{best_index}
+							<< (45 - 3 * column_major(texel));
+				}
+				if (error < ret.error) {
+					ret = EtcCandidate{.bits = bits, .error = error};
+				}
+			}
+		}
+	}
+	return ret.bits;
+}
+
+void decode_eac_alpha(std::uint64_t const bits, Block& out) {
+	auto const base = static_cast<int>(bits >> 56);
+	auto const multiplier = static_cast<int>((bits >> 52) & 15);
+	auto const& modifiers = eac_tables_v[(bits >> 48) & 15];
+	for (auto texel = 0uz; texel < out.size(); ++texel) {
+		auto const index = (bits >> (45 - 3 * column_major(texel))) & 7;
+		out[texel][3] =
+			std::clamp(base + modifiers[index] * multiplier, 0, 255);
+	}
+}
+
+void encode_block(Block const& block, BlockFormat const format,
+				  BlockQuality const quality, std::byte* out) {
+	switch (format) {
+	case BlockFormat::Bc1:
+		write_bc1_color(encode_refined(block, 3, quality, bc1_weights_v,
+									   [&block](Endpoints const& endpoints) {
+										   return encode_bc1_color(block,
+																   endpoints);
+									   }),
+						out);
+		break;
+	case BlockFormat::Bc3:
+		encode_bc3_alpha(block, out);
+		write_bc1_color(encode_refined(block, 3, quality, bc1_weights_v,
+									   [&block](Endpoints const& endpoints) {
+										   return encode_bc1_color(block,
+																   endpoints);
+									   }),
+						out + 8);
+		break;
+	case BlockFormat::Bc7:
+		write_bc7(encode_refined(block, channels_v, quality, bc7_weights_f_v,
+								 [&block](Endpoints const& endpoints) {
+									 return encode_bc7(block, endpoints);
+								 }),
+				  out);
+		break;
+	case BlockFormat::Etc2:
+		write_bits_be(out, encode_eac_alpha(block, quality));
+		write_bits_be(out + 8, encode_etc1(block, quality));
+		break;
+	}
+}
+
+void decode_block(std::byte const* in, BlockFormat const format, Block& out) {
+	for (auto& texel : out) { texel[3] = 255; }
+	switch (format) {
+	case BlockFormat::Bc1: decode_bc1_color(in, false, out); break;
+	case BlockFormat::Bc3:
+		decode_bc3_alpha(in, out);
+		decode_bc1_color(in + 8, true, out);
+		break;
+	case BlockFormat::Bc7: decode_bc7(in, out); break;
+	case BlockFormat::Etc2:
+		decode_eac_alpha(read_bits_be(in), out);
+		decode_etc1(read_bits_be(in + 8), out);
+		break;
+	}
+}
+
+[[nodiscard]] constexpr auto get_block_count(glm::ivec2 const size) {
+	return glm::ivec2{(size.x + 3) / 4, (size.y + 3) / 4};
+}
+} // namespace
+
+auto to_string(BlockFormat const format) -> std::string_view {
+	switch (format) {
+	case BlockFormat::Bc1: return "BC1";
+	case BlockFormat::Bc3: return "BC3";
+	case BlockFormat::Bc7: return "BC7";
+	case BlockFormat::Etc2: return "ETC2";
+	}
+	return "Unknown";
+}
+
+auto to_string(BlockQuality const quality) -> std::string_view {
+	switch (quality) {
+	case BlockQuality::Fast: return "Fast";
+	case BlockQuality::Balanced: return "Balanced";
+	case BlockQuality::High: return "High";
+	}
+	return "Unknown";
+}
+
+auto to_vk_format(BlockFormat const format) -> vk::Format {
+	switch (format) {
+	case BlockFormat::Bc1: return vk::Format::eBc1RgbaSrgbBlock;
+	case BlockFormat::Bc3: return vk::Format::eBc3SrgbBlock;
+	case BlockFormat::Bc7: return vk::Format::eBc7SrgbBlock;
+	case BlockFormat::Etc2: return vk::Format::eEtc2R8G8B8A8SrgbBlock;
+	}
+	return vk::Format::eUndefined;
+}
+
+auto get_block_size(BlockFormat const format) -> std::size_t {
+	return format == BlockFormat::Bc1 ? 8 : 16;
+}
+
+auto is_opaque(Bitmap const& bitmap) -> bool {
+	for (auto i = channels_v - 1; i < bitmap.bytes.size(); i += channels_v) {
+		if (bitmap.bytes[i] != std::byte{0xff}) { return false; }
+	}
+	return true;
+}
+
+auto select_block_format(vk::PhysicalDevice const physical_device,
+						 bool const opaque) -> std::optional<BlockFormat> {
+	auto const candidates =
+		opaque ? std::array{BlockFormat::Bc7, BlockFormat::Bc1,
+							BlockFormat::Etc2}
+			   : std::array{BlockFormat::Bc7, BlockFormat::Bc3,
+							BlockFormat::Etc2};
+	for (auto const format : candidates) {
+		if (supports_sampled_upload(physical_device, to_vk_format(format))) {
+			return format;
+		}
+	}
+	return {};
+}
+
+auto encode_blocks(Bitmap const& bitmap, BlockFormat const format,
+				   BlockEncodeSettings const& settings)
+	-> std::vector<std::byte> {
+	if (bitmap.size.x <= 0 || bitmap.size.y <= 0 ||
+		bitmap.bytes.size() <
+			static_cast<std::size_t>(bitmap.size.x * bitmap.size.y) *
+				channels_v) {
+		return {};
+	}
+	auto const block_count = get_block_count(bitmap.size);
+	auto const block_size = get_block_size(format);
+	auto const row_size = static_cast<std::size_t>(block_count.x) * block_size;
+	auto ret = std::vector<std::byte>(
+		static_cast<std::size_t>(block_count.y) * row_size);
+
+	auto const encode_rows = [&](std::size_t const begin,
+								 std::size_t const end) {
+		for (auto row = begin; row < end; ++row) {
+			auto* out = ret.data() + row * row_size;
+			for (auto column = 0; column < block_count.x; ++column) {
+				auto const block =
+					load_block(bitmap, column, static_cast<int>(row));
+				encode_block(block, format, settings.quality, out);
+				out += block_size;
+			}
+		}
+	};
+	auto const rows = static_cast<std::size_t>(block_count.y);
+	if (settings.jobs == nullptr) {
+		encode_rows(0, rows);
+	} else {
+		settings.jobs->parallel_for(rows, 1, encode_rows);
+	}
+	return ret;
+}
+
+auto encode_mip_chain(Bitmap const& bitmap, MipChain const& chain,
+					  BlockFormat const format,
+					  BlockEncodeSettings const& settings)
+	-> std::vector<std::vector<std::byte>> {
+	auto ret = std::vector<std::vector<std::byte>>{};
+	ret.reserve(chain.offsets.size() + 1);
+	ret.push_back(encode_blocks(bitmap, format, settings));
+	auto const usize = glm::uvec2{bitmap.size};
+	auto const extent = vk::Extent2D{usize.x, usize.y};
+	for (auto const [index, offset] : std::views::enumerate(chain.offsets)) {
+		auto const next = static_cast<std::size_t>(index) + 1;
+		auto const end = next < chain.offsets.size() ? chain.offsets[next]
+													 : chain.bytes.size();
+		auto const level_extent = get_mip_extent(
+			extent, static_cast<std::uint32_t>(index + 1));
+		auto const level_bitmap = Bitmap{
+			.bytes = std::span{chain.bytes}.subspan(offset, end - offset),
+			.size = glm::ivec2{glm::uvec2{level_extent.width,
+										  level_extent.height}},
+		};
+		ret.push_back(encode_blocks(level_bitmap, format, settings));
+	}
+	return ret;
+}
+
+auto encode_image(Bitmap const& bitmap, BlockFormat const format,
+				  std::uint32_t const levels,
+				  BlockEncodeSettings const& settings) -> EncodedImage {
+	auto const usize = glm::uvec2{bitmap.size};
+	auto const chain = build_mip_chain(bitmap, levels);
+	return EncodedImage{
+		.format = format,
+		.extent = vk::Extent2D{usize.x, usize.y},
+		.levels = encode_mip_chain(bitmap, chain, format, settings),
+	};
+}
+
+auto decode_blocks(std::span<std::byte const> blocks, BlockFormat const format,
+				   glm::ivec2 const size) -> std::vector<std::byte> {
+	auto const block_count = get_block_count(size);
+	auto const block_size = get_block_size(format);
+	auto const total_blocks =
+		static_cast<std::size_t>(block_count.x * block_count.y);
+	if (size.x <= 0 || size.y <= 0 ||
+		blocks.size() < total_blocks * block_size) {
+		return {};
+	}
+	auto const width = static_cast<std::size_t>(size.x);
+	auto ret = std::vector<std::byte>(
+		width * static_cast<std::size_t>(size.y) * channels_v);
+	auto block = Block{};
+	for (auto by = 0; by < block_count.y; ++by) {
+		for (auto bx = 0; bx < block_count.x; ++bx) {
+			decode_block(blocks.data(), format, block);
+			blocks = blocks.subspan(block_size);
+			for (auto i = 0uz; i < block.size(); ++i) {
+				auto const x = bx * 4 + static_cast<int>(i % 4);
+				auto const y = by * 4 + static_cast<int>(i / 4);
+				if (x >= size.x || y >= size.y) { continue; }
+				auto const offset = (static_cast<std::size_t>(y) * width +
+									 static_cast<std::size_t>(x)) *
+									channels_v;
+				for (auto c = 0uz; c < channels_v; ++c) {
+					ret[offset + c] = static_cast<std::byte>(block[i][c]);
+				}
+			}
+		}
+	}
+	return ret;
+}
+} // namespace lvk
@@ -0,0 +1,91 @@
+#pragma once
+#include <bitmap.hpp>
+#include <mip_chain.hpp>
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace lvk {
+class JobSystem;
+
+// 4x4 block compressed formats encode_blocks() can write.
+enum class BlockFormat : std::int8_t {
+	// RGB, 1-bit alpha is not used: for opaque bitmaps only.
+	Bc1,
+	// BC1 color with interpolated alpha.
+	Bc3,
+	// RGBA, mode 6 only: a single subset with 4-bit indices.
+	Bc7,
+	// ETC2 RGBA8: ETC1 compatible color with EAC alpha.
+	Etc2,
+};
+
+enum class BlockQuality : std::int8_t {
+	// bounding box endpoints, no refinement.
+	Fast,
+	// principal axis endpoints, refined once.
+	Balanced,
+	// principal axis endpoints, refined until the error stops improving.
+	High,
+};
+
+[[nodiscard]] auto to_string(BlockFormat format) -> std::string_view;
+[[nodiscard]] auto to_string(BlockQuality quality) -> std::string_view;
+
+// sRGB Vulkan format of format.
+[[nodiscard]] auto to_vk_format(BlockFormat format) -> vk::Format;
+// bytes per 4x4 block.
+[[nodiscard]] auto get_block_size(BlockFormat format) -> std::size_t;
+
+// all alpha values are 0xff.
+[[nodiscard]] auto is_opaque(Bitmap const& bitmap) -> bool;
+
+// BC7 if the GPU supports it, else BC1 (opaque) / BC3, else ETC2.
+// returns nullopt if none of them is supported.
+[[nodiscard]] auto select_block_format(vk::PhysicalDevice physical_device,
+									   bool opaque)
+	-> std::optional<BlockFormat>;
+
+struct BlockEncodeSettings {
+	BlockQuality quality{BlockQuality::Balanced};
+	// optional, rows of blocks are encoded in parallel if set.
+	JobSystem* jobs{};
+};
+
+// encodes an RGBA8 bitmap into blocks (row-major), partial blocks at the
+// edges are padded by repeating edge texels.
+[[nodiscard]] auto encode_blocks(Bitmap const& bitmap, BlockFormat format,
+								 BlockEncodeSettings const& settings = {})
+	-> std::vector<std::byte>;
+
+// encodes bitmap and each level of chain (built from it by
+// build_mip_chain()): one vector of blocks per level, base level first.
+[[nodiscard]] auto encode_mip_chain(Bitmap const& bitmap, MipChain const& chain,
+									BlockFormat format,
+									BlockEncodeSettings const& settings = {})
+	-> std::vector<std::vector<std::byte>>;
+
+// bitmap and its mip chain encoded by encode_image(), ready to be staged.
+struct EncodedImage {
+	BlockFormat format{};
+	vk::Extent2D extent{};
+	// blocks of each level, base level first.
+	std::vector<std::vector<std::byte>> levels{};
+};
+
+// builds the levels below bitmap's on the CPU (build_mip_chain()) and
+// encodes all of them: levels includes the base level.
+[[nodiscard]] auto encode_image(Bitmap const& bitmap, BlockFormat format,
+								std::uint32_t levels,
+								BlockEncodeSettings const& settings = {})
+	-> EncodedImage;
+
+// decodes blocks written by encode_blocks() into RGBA8, for measuring
+// quality.
+[[nodiscard]] auto decode_blocks(std::span<std::byte const> blocks,
+								 BlockFormat format, glm::ivec2 size)
+	-> std::vector<std::byte>;
+} // namespace lvk
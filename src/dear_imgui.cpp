@@ -3,10 +3,16 @@
 #include <dear_imgui.hpp>
 #include <glm/gtc/color_space.hpp>
 #include <glm/mat4x4.hpp>
-#include <resource_buffering.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 namespace lvk {
+namespace {
+auto has_platform_backend() -> bool {
+	return ImGui::GetIO().BackendPlatformUserData != nullptr;
+}
+} // namespace
+
 DearImGui::DearImGui(CreateInfo const& create_info) {
 	IMGUI_CHECKVERSION();
 	ImGui::CreateContext();
@@ -19,9 +25,13 @@ DearImGui::DearImGui(CreateInfo const& create_info) {
 	ImGui_ImplVulkan_LoadFunctions(create_info.api_version, load_vk_func,
 								   &instance);
 
-	if (!ImGui_ImplGlfw_InitForVulkan(create_info.window, true)) {
+	// without a window there is no platform backend, new_frame() supplies
+	// the display size and delta time instead.
+	if (create_info.window != nullptr &&
+		!ImGui_ImplGlfw_InitForVulkan(create_info.window, true)) {
 		throw std::runtime_error{"Failed to initialize Dear ImGui"};
 	}
+	m_display_size = glm::vec2{create_info.display_size};
 
 	auto init_info = ImGui_ImplVulkan_InitInfo{};
 	init_info.ApiVersion = create_info.api_version;
@@ -31,7 +41,8 @@ DearImGui::DearImGui(CreateInfo const& create_info) {
 	init_info.QueueFamily = create_info.queue_family;
 	init_info.Queue = create_info.queue;
 	init_info.MinImageCount = 2;
-	init_info.ImageCount = static_cast<std::uint32_t>(resource_buffering_v);
+	init_info.ImageCount =
+		std::max(create_info.buffering, init_info.MinImageCount);
 	init_info.MSAASamples =
 		static_cast<VkSampleCountFlagBits>(create_info.samples);
 	init_info.DescriptorPoolSize = 2;
@@ -59,7 +70,13 @@ DearImGui::DearImGui(CreateInfo const& create_info) {
 
 void DearImGui::new_frame() {
 	if (m_state == State::Begun) { end_frame(); }
-	ImGui_ImplGlfw_NewFrame();
+	if (has_platform_backend()) {
+		ImGui_ImplGlfw_NewFrame();
+	} else {
+		auto& io = ImGui::GetIO();
+		io.DisplaySize = ImVec2{m_display_size.x, m_display_size.y};
+		io.DeltaTime = 1.0f / 60.0f;
+	}
 	ImGui_ImplVulkan_NewFrame();
 	ImGui::NewFrame();
 	m_state = State::Begun;
@@ -82,7 +99,7 @@ void DearImGui::Deleter::operator()(vk::Device const device) const {
 	device.waitIdle();
 	ImGui_ImplVulkan_DestroyFontsTexture();
 	ImGui_ImplVulkan_Shutdown();
-	ImGui_ImplGlfw_Shutdown();
+	if (has_platform_backend()) { ImGui_ImplGlfw_Shutdown(); }
 	ImGui::DestroyContext();
 }
 } // namespace lvk
@@ -1,5 +1,6 @@
 #pragma once
 #include <GLFW/glfw3.h>
+#include <glm/vec2.hpp>
 #include <imgui.h>
 #include <scoped.hpp>
 #include <vulkan/vulkan.hpp>
@@ -7,7 +8,7 @@
 
 namespace lvk {
 struct DearImGuiCreateInfo {
-	GLFWwindow* window{};
+	GLFWwindow* window{}; // null when headless.
 	std::uint32_t api_version{};
 	vk::Instance instance{};
 	vk::PhysicalDevice physical_device{};
@@ -16,6 +17,8 @@ struct DearImGuiCreateInfo {
 	vk::Queue queue{};
 	vk::Format color_format{}; // single color attachment.
 	vk::SampleCountFlagBits samples{};
+	std::uint32_t buffering{}; // number of virtual frames.
+	glm::ivec2 display_size{}; // used when there is no window.
 };
 
 class DearImGui {
@@ -36,6 +39,7 @@ class DearImGui {
 	};
 
 	State m_state{};
+	glm::vec2 m_display_size{};
 
 	Scoped<vk::Device, Deleter> m_device{};
 };
@@ -0,0 +1,22 @@
+#include <deferred_queue.hpp>
+
+namespace lvk {
+void DeferredQueue::begin_frame(std::uint64_t const drawn_value) {
+	m_drawn_value = drawn_value;
+}
+
+void DeferredQueue::collect(std::uint64_t const completed_value) {
+	// buckets are ordered by drawn value.
+	while (!m_buckets.empty() &&
+		   m_buckets.front().drawn_value <= completed_value) {
+		m_buckets.pop_front();
+	}
+}
+
+auto DeferredQueue::current_bucket() -> Bucket& {
+	if (m_buckets.empty() || m_buckets.back().drawn_value != m_drawn_value) {
+		m_buckets.push_back(Bucket{.drawn_value = m_drawn_value});
+	}
+	return m_buckets.back();
+}
+} // namespace lvk
@@ -0,0 +1,65 @@
+#pragma once
+#include <scoped.hpp>
+#include <concepts>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace lvk {
+// Defers destruction of released resources (Scoped<Type, Deleter>,
+// vk::Unique*, or any other movable owner) until the frame that released
+// them has been drawn, ie the render timeline has reached its value.
+class DeferredQueue {
+  public:
+	// resources released from now on are destroyed once the render timeline
+	// reaches drawn_value.
+	void begin_frame(std::uint64_t drawn_value);
+
+	template <std::movable Type>
+	void release(Type resource) {
+		// ignore null handles.
+		if constexpr (std::constructible_from<bool, Type const&>) {
+			if (!static_cast<bool>(resource)) { return; }
+		}
+		push(std::move(resource));
+	}
+
+	template <Scopeable Type, typename Deleter>
+	void release(Scoped<Type, Deleter> resource) {
+		// ignore empty Scoped instances.
+		if (resource.get() == Type{}) { return; }
+		push(std::move(resource));
+	}
+
+	// destroys resources released in frames that have been drawn.
+	void collect(std::uint64_t completed_value);
+
+	// destroys all resources, the device must be idle.
+	void clear() { m_buckets.clear(); }
+
+  private:
+	using Entry = std::unique_ptr<void, void (*)(void*)>;
+
+	struct Bucket {
+		std::uint64_t drawn_value{};
+		std::vector<Entry> entries{};
+	};
+
+	template <typename Type>
+	void push(Type resource) {
+		static constexpr auto deleter_v = [](void* ptr) {
+			// NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+			delete static_cast<Type*>(ptr);
+		};
+		// NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+		auto entry = Entry{new Type(std::move(resource)), deleter_v};
+		current_bucket().entries.push_back(std::move(entry));
+	}
+
+	[[nodiscard]] auto current_bucket() -> Bucket&;
+
+	std::deque<Bucket> m_buckets{};
+	std::uint64_t m_drawn_value{};
+};
+} // namespace lvk
@@ -0,0 +1,330 @@
+#include <defragmenter.hpp>
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace lvk {
+namespace {
+// fragmentation statistics are not free to compute.
+constexpr std::uint32_t check_interval_v{300};
+
+constexpr auto to_mib(std::uint64_t const bytes) -> double {
+	return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+[[nodiscard]] auto subresource_range(vma::RawImage const& image) {
+	auto ret = vk::ImageSubresourceRange{};
+	ret.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(image.layers)
+		.setLevelCount(image.levels);
+	return ret;
+}
+} // namespace
+
+Defragmenter::Defragmenter(CreateInfo const& create_info)
+	: m_create_info(create_info) {}
+
+Defragmenter::~Defragmenter() {
+	if (m_pass_value) {
+		vmaEndDefragmentationPass(m_create_info.allocator, m_context, &m_pass);
+	}
+	if (m_context != nullptr) { finish(); }
+}
+
+void Defragmenter::track(vma::Buffer& buffer, OnMoved on_moved) {
+	auto const allocation = buffer.get().allocation;
+	if (allocation == nullptr) { return; }
+	if (buffer.get().mapped != nullptr) {
+		// writes between a pass' copy and its end would be lost.
+		spdlog::warn("[Defragmenter] Mapped Buffers cannot be tracked");
+		return;
+	}
+	auto tracked = Tracked{.buffer = &buffer, .on_moved = std::move(on_moved)};
+	m_tracked.insert_or_assign(allocation, std::move(tracked));
+}
+
+void Defragmenter::track(vma::Image& image, OnMoved on_moved) {
+	auto const allocation = image.get().allocation;
+	if (allocation == nullptr) { return; }
+	auto tracked = Tracked{.image = &image, .on_moved = std::move(on_moved)};
+	m_tracked.insert_or_assign(allocation, std::move(tracked));
+}
+
+void Defragmenter::untrack(VmaAllocation const allocation) {
+	m_tracked.erase(allocation);
+}
+
+void Defragmenter::update(std::uint64_t const drawn_value) {
+	if (!m_pass_value || drawn_value < *m_pass_value) { return; }
+	m_pass_value.reset();
+	// moved allocations now refer to their new memory, the old memory is
+	// freed: frames using it have been drawn.
+	auto const result =
+		vmaEndDefragmentationPass(m_create_info.allocator, m_context, &m_pass);
+	if (result == VK_SUCCESS) { finish(); }
+}
+
+void Defragmenter::record(vk::CommandBuffer const command_buffer,
+						  std::uint64_t const frame_value) {
+	// the previous pass hasn't ended yet.
+	if (m_pass_value) { return; }
+	if (m_context == nullptr) {
+		if (!should_start()) { return; }
+		begin();
+		if (m_context == nullptr) { return; }
+	}
+
+	m_pass = VmaDefragmentationPassMoveInfo{};
+	auto const result = vmaBeginDefragmentationPass(m_create_info.allocator,
+													m_context, &m_pass);
+	if (result == VK_SUCCESS) {
+		// nothing (more) to move.
+		finish();
+		return;
+	}
+	if (result != VK_INCOMPLETE) {
+		spdlog::error("[Defragmenter] Failed to begin pass");
+		finish();
+		return;
+	}
+
+	auto moves = std::vector<Move>{};
+	moves.reserve(m_pass.moveCount);
+	for (auto& move : std::span{m_pass.pMoves, m_pass.moveCount}) {
+		auto const it = m_tracked.find(move.srcAllocation);
+		auto const destination = it == m_tracked.end()
+									 ? Move{}
+									 : create_destination(move, it->second);
+		if (destination.tracked == nullptr) {
+			// untracked (or failed): leave where it is.
+			move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+			continue;
+		}
+		moves.push_back(destination);
+	}
+
+	record_copies(command_buffer, moves);
+	swap_handles(moves);
+	m_pass_value = frame_value;
+	++m_stats.passes;
+}
+
+void Defragmenter::inspect() {
+	ImGui::Text("%s", is_running() ? "running" : "idle");
+	ImGui::Text("runs: %llu, passes: %llu",
+				static_cast<unsigned long long>(m_stats.runs),
+				static_cast<unsigned long long>(m_stats.passes));
+	ImGui::Text("moved: %llu allocations, %.2f MiB",
+				static_cast<unsigned long long>(m_stats.allocations_moved),
+				to_mib(m_stats.bytes_moved));
+	ImGui::Text("reclaimed: %.2f MiB (%llu blocks)",
+				to_mib(m_stats.bytes_freed),
+				static_cast<unsigned long long>(m_stats.blocks_freed));
+	if (!is_running() && ImGui::Button("defragment")) { request(); }
+}
+
+auto Defragmenter::should_start() -> bool {
+	if (std::exchange(m_requested, false)) { return true; }
+	if (m_tracked.empty() || ++m_frames_since_check < check_interval_v) {
+		return false;
+	}
+	m_frames_since_check = 0;
+
+	auto stats = VmaTotalStatistics{};
+	vmaCalculateStatistics(m_create_info.allocator, &stats);
+	auto const& total = stats.total.statistics;
+	auto const unused = total.blockBytes - total.allocationBytes;
+	auto const threshold = static_cast<double>(total.blockBytes) *
+						   static_cast<double>(m_create_info.min_unused_ratio);
+	return unused >= m_create_info.min_unused_bytes &&
+		   static_cast<double>(unused) >= threshold;
+}
+
+void Defragmenter::begin() {
+	auto defrag_info = VmaDefragmentationInfo{};
+	defrag_info.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT;
+	defrag_info.maxBytesPerPass = m_create_info.max_bytes_per_pass;
+	defrag_info.maxAllocationsPerPass = m_create_info.max_moves_per_pass;
+	auto const result = vmaBeginDefragmentation(m_create_info.allocator,
+												&defrag_info, &m_context);
+	if (result != VK_SUCCESS) {
+		spdlog::error("[Defragmenter] Failed to begin defragmentation");
+		m_context = nullptr;
+		return;
+	}
+	++m_stats.runs;
+}
+
+void Defragmenter::finish() {
+	auto stats = VmaDefragmentationStats{};
+	vmaEndDefragmentation(m_create_info.allocator, m_context, &stats);
+	m_context = nullptr;
+	m_stats.allocations_moved += stats.allocationsMoved;
+	m_stats.bytes_moved += stats.bytesMoved;
+	m_stats.bytes_freed += stats.bytesFreed;
+	m_stats.blocks_freed += stats.deviceMemoryBlocksFreed;
+	spdlog::info("[Defragmenter] Moved {} allocations ({:.2f} MiB), "
+				 "reclaimed {:.2f} MiB ({} blocks)",
+				 stats.allocationsMoved, to_mib(stats.bytesMoved),
+				 to_mib(stats.bytesFreed), stats.deviceMemoryBlocksFreed);
+}
+
+auto Defragmenter::create_destination(VmaDefragmentationMove const& move,
+									  Tracked& tracked) const -> Move {
+	auto const allocator = m_create_info.allocator;
+	auto const device = m_create_info.device;
+	if (tracked.buffer != nullptr) {
+		auto const& raw = tracked.buffer->get();
+		auto buffer_ci = vk::BufferCreateInfo{};
+		buffer_ci.setSize(raw.size).setUsage(raw.usage);
+		auto const buffer = device.createBuffer(buffer_ci);
+		if (vmaBindBufferMemory(allocator, move.dstTmpAllocation, buffer) !=
+			VK_SUCCESS) {
+			device.destroyBuffer(buffer);
+			return {};
+		}
+		return Move{.tracked = &tracked, .buffer = buffer};
+	}
+
+	auto const& raw = tracked.image->get();
+	auto image_ci = vk::ImageCreateInfo{};
+	image_ci.setImageType(vk::ImageType::e2D)
+		.setExtent({raw.extent.width, raw.extent.height, 1})
+		.setFormat(raw.format)
+		.setUsage(raw.usage)
+		.setArrayLayers(raw.layers)
+		.setMipLevels(raw.levels)
+		.setSamples(vk::SampleCountFlagBits::e1)
+		.setTiling(vk::ImageTiling::eOptimal)
+		.setInitialLayout(vk::ImageLayout::eUndefined);
+	auto const image = device.createImage(image_ci);
+	if (vmaBindImageMemory(allocator, move.dstTmpAllocation, image) !=
+		VK_SUCCESS) {
+		device.destroyImage(image);
+		return {};
+	}
+	return Move{.tracked = &tracked, .image = image};
+}
+
+void Defragmenter::record_copies(vk::CommandBuffer const command_buffer,
+								 std::span<Move const> moves) const {
+	if (moves.empty()) { return; }
+
+	// wait for all prior (frames') access to the source and destination
+	// memory, and transition images for transfer.
+	auto memory_barrier = vk::MemoryBarrier2{};
+	memory_barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+		.setSrcAccessMask(vk::AccessFlagBits2::eMemoryWrite)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+		.setDstAccessMask(vk::AccessFlagBits2::eTransferRead |
+						  vk::AccessFlagBits2::eTransferWrite);
+	auto image_barriers = std::vector<vk::ImageMemoryBarrier2>{};
+	for (auto const& move : moves) {
+		if (!move.image) { continue; }
+		auto const& raw = move.tracked->image->get();
+		auto barrier = vk::ImageMemoryBarrier2{};
+		barrier.setImage(raw.image)
+			.setSubresourceRange(subresource_range(raw))
+			.setOldLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+			.setSrcStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+			.setSrcAccessMask(vk::AccessFlagBits2::eNone)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+			.setDstAccessMask(vk::AccessFlagBits2::eTransferRead);
+		image_barriers.push_back(barrier);
+		barrier.setImage(move.image)
+			.setOldLayout(vk::ImageLayout::eUndefined)
+			.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+		image_barriers.push_back(barrier);
+	}
+	auto dependency_info = vk::DependencyInfo{};
+	dependency_info.setMemoryBarriers(memory_barrier)
+		.setImageMemoryBarriers(image_barriers);
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	auto subresource_layers = vk::ImageSubresourceLayers{};
+	subresource_layers.setAspectMask(vk::ImageAspectFlagBits::eColor);
+	auto image_copies = std::vector<vk::ImageCopy2>{};
+	for (auto const& move : moves) {
+		if (move.buffer) {
+			auto const& raw = move.tracked->buffer->get();
+			auto buffer_copy = vk::BufferCopy2{};
+			buffer_copy.setSize(raw.size);
+			auto copy_buffer_info = vk::CopyBufferInfo2{};
+			copy_buffer_info.setSrcBuffer(raw.buffer)
+				.setDstBuffer(move.buffer)
+				.setRegions(buffer_copy);
+			command_buffer.copyBuffer2(copy_buffer_info);
+			continue;
+		}
+
+		// one region per mip level.
+		auto const& raw = move.tracked->image->get();
+		subresource_layers.setLayerCount(raw.layers);
+		image_copies.clear();
+		for (auto level = 0u; level < raw.levels; ++level) {
+			subresource_layers.setMipLevel(level);
+			auto const extent = vk::Extent3D{
+				std::max(raw.extent.width >> level, 1u),
+				std::max(raw.extent.height >> level, 1u),
+				1,
+			};
+			auto image_copy = vk::ImageCopy2{};
+			image_copy.setSrcSubresource(subresource_layers)
+				.setDstSubresource(subresource_layers)
+				.setExtent(extent);
+			image_copies.push_back(image_copy);
+		}
+		auto copy_image_info = vk::CopyImageInfo2{};
+		copy_image_info.setSrcImage(raw.image)
+			.setSrcImageLayout(vk::ImageLayout::eTransferSrcOptimal)
+			.setDstImage(move.image)
+			.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setRegions(image_copies);
+		command_buffer.copyImage2(copy_image_info);
+	}
+
+	// make the copies visible to subsequent use.
+	memory_barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+		.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+		.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead);
+	image_barriers.clear();
+	for (auto const& move : moves) {
+		if (!move.image) { continue; }
+		auto barrier = vk::ImageMemoryBarrier2{};
+		barrier.setImage(move.image)
+			.setSubresourceRange(subresource_range(move.tracked->image->get()))
+			.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+			.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eAllGraphics)
+			.setDstAccessMask(vk::AccessFlagBits2::eShaderSampledRead);
+		image_barriers.push_back(barrier);
+	}
+	dependency_info.setMemoryBarriers(memory_barrier)
+		.setImageMemoryBarriers(image_barriers);
+	command_buffer.pipelineBarrier2(dependency_info);
+}
+
+void Defragmenter::swap_handles(std::span<Move const> moves) {
+	auto const device = m_create_info.device;
+	for (auto const& move : moves) {
+		// the old handles may still be in use by frames in flight.
+		if (move.buffer) {
+			auto& raw = move.tracked->buffer->get();
+			auto const old = std::exchange(raw.buffer, move.buffer);
+			m_create_info.deferred->release(vk::UniqueBuffer{old, device});
+		} else {
+			auto& raw = move.tracked->image->get();
+			auto const old = std::exchange(raw.image, move.image);
+			m_create_info.deferred->release(vk::UniqueImage{old, device});
+		}
+		if (move.tracked->on_moved) { move.tracked->on_moved(); }
+	}
+}
+} // namespace lvk
@@ -0,0 +1,121 @@
+#pragma once
+#include <deferred_queue.hpp>
+#include <vma.hpp>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <unordered_map>
+
+namespace lvk {
+struct DefragmenterCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	// old Buffer / Image handles are released here.
+	DeferredQueue* deferred;
+	// limits of each pass, one pass is recorded per frame.
+	vk::DeviceSize max_bytes_per_pass{8 * 1024 * 1024};
+	std::uint32_t max_moves_per_pass{32};
+	// a defragmentation starts automatically when unused bytes in VMA
+	// blocks exceed both of these.
+	vk::DeviceSize min_unused_bytes{16 * 1024 * 1024};
+	float min_unused_ratio{0.25f};
+};
+
+struct DefragmenterStats {
+	std::uint64_t runs{};
+	std::uint64_t passes{};
+	std::uint64_t allocations_moved{};
+	std::uint64_t bytes_moved{};
+	// memory returned by freeing emptied VMA blocks.
+	std::uint64_t bytes_freed{};
+	std::uint64_t blocks_freed{};
+};
+
+// Incrementally defragments VMA memory: each frame moves a bounded number of
+// tracked allocations, by recording copies into the frame's Command Buffer
+// and replacing the handles of tracked vma::Buffer / vma::Image instances in
+// place (their addresses are the stable handles). Old handles are released
+// into the DeferredQueue, and a pass ends once its frame has been drawn.
+// Untracked allocations are never moved.
+class Defragmenter {
+  public:
+	using CreateInfo = DefragmenterCreateInfo;
+	// invoked after a tracked resource's handle has been replaced, to
+	// refresh views / descriptors that refer to it.
+	using OnMoved = std::function<void()>;
+
+	explicit Defragmenter(CreateInfo const& create_info);
+	// ends any ongoing defragmentation, the device must be idle.
+	~Defragmenter();
+
+	Defragmenter(Defragmenter const&) = delete;
+	Defragmenter(Defragmenter&&) = delete;
+	auto operator=(Defragmenter const&) = delete;
+	auto operator=(Defragmenter&&) = delete;
+
+	// buffer / image must not move in memory and must stay alive until
+	// untracked, and must have been created with TransferSrc usage.
+	// mapped (Host) Buffers are not tracked.
+	// images must be in ShaderReadOnlyOptimal layout between frames.
+	void track(vma::Buffer& buffer, OnMoved on_moved = {});
+	void track(vma::Image& image, OnMoved on_moved = {});
+	void untrack(VmaAllocation allocation);
+
+	// starts a defragmentation on the next record(), regardless of
+	// fragmentation.
+	void request() { m_requested = true; }
+
+	// ends the current pass once the frame that recorded it has been drawn.
+	void update(std::uint64_t drawn_value);
+	// begins the next pass (and starts a defragmentation if requested or
+	// fragmented), records copies for its moves into command_buffer, whose
+	// submission signals frame_value on the render timeline.
+	// must be recorded outside rendering, before moved resources are used.
+	void record(vk::CommandBuffer command_buffer, std::uint64_t frame_value);
+
+	[[nodiscard]] auto is_running() const -> bool {
+		return m_context != nullptr;
+	}
+	[[nodiscard]] auto get_stats() const -> DefragmenterStats const& {
+		return m_stats;
+	}
+
+	// draws ImGui widgets (within the current window).
+	void inspect();
+
+  private:
+	struct Tracked {
+		vma::Buffer* buffer{};
+		vma::Image* image{};
+		OnMoved on_moved{};
+	};
+
+	struct Move {
+		Tracked* tracked{};
+		vk::Buffer buffer{};
+		vk::Image image{};
+	};
+
+	[[nodiscard]] auto should_start() -> bool;
+	void begin();
+	void finish();
+	[[nodiscard]] auto create_destination(VmaDefragmentationMove const& move,
+										  Tracked& tracked) const -> Move;
+	void record_copies(vk::CommandBuffer command_buffer,
+					   std::span<Move const> moves) const;
+	void swap_handles(std::span<Move const> moves);
+
+	CreateInfo m_create_info{};
+	std::unordered_map<VmaAllocation, Tracked> m_tracked{};
+	bool m_requested{};
+	// frames since fragmentation was last checked.
+	std::uint32_t m_frames_since_check{};
+
+	VmaDefragmentationContext m_context{};
+	VmaDefragmentationPassMoveInfo m_pass{};
+	// value of the frame that recorded the current pass.
+	std::optional<std::uint64_t> m_pass_value{};
+	DefragmenterStats m_stats{};
+};
+} // namespace lvk
@@ -0,0 +1,214 @@
+#include <frame_arena.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace lvk {
+namespace {
+[[nodiscard]] constexpr auto align_up(vk::DeviceSize const value,
+									  vk::DeviceSize const alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+FrameArena::FrameArena(CreateInfo const& create_info)
+	: m_create_info(create_info) {
+	m_create_info.uniform_alignment =
+		std::max(m_create_info.uniform_alignment, vk::DeviceSize{1});
+	m_create_info.storage_alignment =
+		std::max(m_create_info.storage_alignment, vk::DeviceSize{1});
+	m_create_info.buffering = std::max(m_create_info.buffering, 1uz);
+	// keep every region's start aligned for both descriptor types.
+	m_alignment = std::max(m_create_info.uniform_alignment,
+						   m_create_info.storage_alignment);
+	m_min_capacity = align_up(
+		std::max(m_create_info.frame_capacity, vk::DeviceSize{1}), m_alignment);
+
+	if (!reallocate(m_min_capacity)) {
+		throw std::runtime_error{"Failed to create frame arena Buffer"};
+	}
+	if (is_staged()) {
+		spdlog::info("[FrameArena] Device memory not host visible, staging");
+	} else {
+		spdlog::info("[FrameArena] Writing directly to Device memory");
+	}
+}
+
+void FrameArena::reserve(vk::DeviceSize const frame_bytes) {
+	m_reserved = align_up(frame_bytes, m_alignment);
+}
+
+auto FrameArena::begin_frame(std::size_t const frame_index) -> bool {
+	// usage of the frame recorded last.
+	auto const used = std::max(get_frame_used(), m_demand);
+	m_demand = 0;
+
+	auto reallocated = false;
+	auto const required = std::max(used, m_reserved);
+	if (required > m_frame_capacity) {
+		// grow geometrically, so that steadily increasing usage doesn't
+		// reallocate every frame.
+		auto const grown =
+			scale(m_frame_capacity, m_create_info.growth_factor);
+		reallocated = reallocate(std::max(required, grown));
+		if (reallocated) { ++m_stats.grows; }
+	} else if (should_shrink(used)) {
+		// leave headroom so that the next growth doesn't follow right away.
+		auto const shrunk = std::max(
+			{scale(used, m_create_info.growth_factor), m_reserved,
+			 m_min_capacity});
+		if (shrunk < m_frame_capacity) {
+			reallocated = reallocate(shrunk);
+			if (reallocated) { ++m_stats.shrinks; }
+		}
+		m_low_frames = 0;
+	}
+
+	m_frame_begin = m_frame_capacity * frame_index;
+	m_head = m_frame_begin;
+	return reallocated;
+}
+
+auto FrameArena::allocate(vk::DeviceSize const size,
+						  vk::DeviceSize const alignment)
+	-> std::optional<ArenaAllocation> {
+	auto const offset =
+		align_up(m_head, std::max(alignment, vk::DeviceSize{1}));
+	if (offset + size > m_frame_begin + m_frame_capacity) {
+		spdlog::error("[FrameArena] Out of space: {} + {} bytes > {}",
+					  get_frame_used(), size, m_frame_capacity);
+		// grown to fit by the next begin_frame().
+		m_demand = std::max(m_demand, offset + size - m_frame_begin);
+		++m_stats.failures;
+		return {};
+	}
+	m_head = offset + size;
+	return ArenaAllocation{
+		.offset = static_cast<std::uint32_t>(offset),
+		.bytes = get_mapped().mapped_span().subspan(offset, size),
+	};
+}
+
+auto FrameArena::write_uniform(std::span<std::byte const> const bytes)
+	-> std::optional<ArenaAllocation> {
+	auto ret = allocate(bytes.size(), m_create_info.uniform_alignment);
+	if (ret) { std::memcpy(ret->bytes.data(), bytes.data(), bytes.size()); }
+	return ret;
+}
+
+auto FrameArena::write_storage(std::span<std::byte const> const bytes)
+	-> std::optional<ArenaAllocation> {
+	auto ret = allocate(bytes.size(), m_create_info.storage_alignment);
+	if (ret) { std::memcpy(ret->bytes.data(), bytes.data(), bytes.size()); }
+	return ret;
+}
+
+void FrameArena::commit(vk::CommandBuffer const command_buffer) const {
+	auto const size = get_frame_used();
+	if (size == 0) { return; }
+	if (!is_staged()) {
+		vma::flush_buffer(m_buffer.get(), m_frame_begin, size);
+		return;
+	}
+
+	vma::flush_buffer(m_staging.get(), m_frame_begin, size);
+	auto buffer_copy = vk::BufferCopy2{};
+	buffer_copy.setSrcOffset(m_frame_begin)
+		.setDstOffset(m_frame_begin)
+		.setSize(size);
+	auto copy_buffer_info = vk::CopyBufferInfo2{};
+	copy_buffer_info.setSrcBuffer(m_staging.get().buffer)
+		.setDstBuffer(m_buffer.get().buffer)
+		.setRegions(buffer_copy);
+	command_buffer.copyBuffer2(copy_buffer_info);
+
+	// make the copy visible to shader reads.
+	auto barrier = vk::BufferMemoryBarrier2{};
+	barrier.setBuffer(m_buffer.get().buffer)
+		.setOffset(m_frame_begin)
+		.setSize(size)
+		.setSrcStageMask(vk::PipelineStageFlagBits2::eCopy)
+		.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eVertexShader |
+						 vk::PipelineStageFlagBits2::eFragmentShader)
+		.setDstAccessMask(vk::AccessFlagBits2::eUniformRead |
+						  vk::AccessFlagBits2::eShaderStorageRead);
+	auto dependency_info = vk::DependencyInfo{};
+	dependency_info.setBufferMemoryBarriers(barrier);
+	command_buffer.pipelineBarrier2(dependency_info);
+}
+
+auto FrameArena::descriptor_info(vk::DeviceSize const range) const
+	-> vk::DescriptorBufferInfo {
+	auto ret = vk::DescriptorBufferInfo{};
+	ret.setBuffer(m_buffer.get().buffer)
+		.setRange(std::min(range, m_frame_capacity));
+	return ret;
+}
+
+auto FrameArena::reallocate(vk::DeviceSize const frame_capacity) -> bool {
+	// a region per virtual frame, and a frame's worth of slack.
+	auto const size = frame_capacity * (m_create_info.buffering + 1);
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = m_create_info.allocator,
+		.usage = vk::BufferUsageFlagBits::eUniformBuffer |
+				 vk::BufferUsageFlagBits::eStorageBuffer,
+		.queue_family = m_create_info.queue_family,
+	};
+	auto buffer =
+		vma::create_buffer(buffer_ci, vma::BufferMemoryType::DeviceHost, size);
+	if (!buffer.get().buffer) {
+		spdlog::error("[FrameArena] Failed to create Buffer ({} bytes)", size);
+		return false;
+	}
+	auto staging = vma::Buffer{};
+	if (buffer.get().mapped == nullptr) {
+		auto const staging_ci = vma::BufferCreateInfo{
+			.allocator = m_create_info.allocator,
+			.usage = vk::BufferUsageFlagBits::eTransferSrc,
+			.queue_family = m_create_info.queue_family,
+		};
+		staging =
+			vma::create_buffer(staging_ci, vma::BufferMemoryType::Host, size);
+		if (!staging.get().buffer) {
+			spdlog::error("[FrameArena] Failed to create staging Buffer ({} "
+						  "bytes)",
+						  size);
+			return false;
+		}
+	}
+
+	// the current Buffers may still be in use by frames in flight.
+	m_create_info.deferred->release(std::exchange(m_buffer, std::move(buffer)));
+	m_create_info.deferred->release(
+		std::exchange(m_staging, std::move(staging)));
+	m_frame_capacity = frame_capacity;
+	m_low_frames = 0;
+	return true;
+}
+
+auto FrameArena::should_shrink(vk::DeviceSize const used) -> bool {
+	if (m_create_info.shrink_delay == 0 ||
+		m_frame_capacity <= std::max(m_min_capacity, m_reserved)) {
+		return false;
+	}
+	auto const threshold = static_cast<double>(m_frame_capacity) *
+						   static_cast<double>(m_create_info.shrink_threshold);
+	if (static_cast<double>(used) >= threshold) {
+		m_low_frames = 0;
+		return false;
+	}
+	// shrink only once usage has stayed low for a while.
+	return ++m_low_frames >= m_create_info.shrink_delay;
+}
+
+auto FrameArena::scale(vk::DeviceSize const size, float const factor) const
+	-> vk::DeviceSize {
+	auto const scaled = static_cast<vk::DeviceSize>(
+		std::ceil(static_cast<double>(size) * static_cast<double>(factor)));
+	return align_up(scaled, m_alignment);
+}
+} // namespace lvk
@@ -0,0 +1,134 @@
+#pragma once
+#include <deferred_queue.hpp>
+#include <vma.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace lvk {
+struct ArenaAllocation {
+	// offset into the arena Buffer, used as the dynamic offset.
+	std::uint32_t offset{};
+	std::span<std::byte> bytes{};
+};
+
+struct FrameArenaCreateInfo {
+	VmaAllocator allocator;
+	std::uint32_t queue_family;
+	// minUniformBufferOffsetAlignment / minStorageBufferOffsetAlignment.
+	vk::DeviceSize uniform_alignment;
+	vk::DeviceSize storage_alignment;
+	std::size_t buffering;
+	// initial bytes available to each virtual frame, never shrunk below.
+	vk::DeviceSize frame_capacity;
+	// replaced Buffers are released into it.
+	DeferredQueue* deferred;
+
+	// frame capacity is multiplied by (at least) this much when growing.
+	float growth_factor{2.0f};
+	// usage ratio (bytes / frame capacity) below which the arena is a shrink
+	// candidate.
+	float shrink_threshold{0.25f};
+	// consecutive frames below shrink_threshold before shrinking, 0 disables
+	// shrinking.
+	std::uint32_t shrink_delay{120};
+};
+
+struct FrameArenaStats {
+	// Buffers reallocated to grow / shrink the frame capacity.
+	std::uint64_t grows{};
+	std::uint64_t shrinks{};
+	// allocations that did not fit in their frame's region.
+	std::uint64_t failures{};
+};
+
+// One persistently mapped Buffer split into a region per virtual frame, which
+// per-frame data (uniforms, storage) is bump allocated from. Allocations are
+// bound through eUniformBufferDynamic / eStorageBufferDynamic descriptors
+// with their offsets as dynamic offsets, so descriptor sets stay static.
+// The Buffer is Device local when that memory is host visible (ReBAR / UMA),
+// else writes go to a Host staging Buffer and are copied by commit().
+// The Buffer is only reallocated by begin_frame(): grown geometrically to
+// fit reserve() and allocations that failed in the previous frame, and
+// shrunk once usage has stayed low for shrink_delay frames.
+class FrameArena {
+  public:
+	using CreateInfo = FrameArenaCreateInfo;
+
+	explicit FrameArena(CreateInfo const& create_info);
+
+	// grows each frame's region to at least frame_bytes on the next
+	// begin_frame(), and keeps it from shrinking below the latest value.
+	void reserve(vk::DeviceSize frame_bytes);
+
+	// resets the frame's region, whose previous allocations must not be in
+	// use anymore (ie the frame's previous submission has been drawn).
+	// returns true if the Buffer was reallocated: descriptors bound to it
+	// must be rewritten (see descriptor_info()), the previous one is
+	// released into the deferred queue.
+	[[nodiscard]] auto begin_frame(std::size_t frame_index) -> bool;
+
+	// returns nullopt if the frame's region is out of space.
+	[[nodiscard]] auto allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+		-> std::optional<ArenaAllocation>;
+	// copies bytes into a uniform / storage aligned allocation.
+	[[nodiscard]] auto write_uniform(std::span<std::byte const> bytes)
+		-> std::optional<ArenaAllocation>;
+	[[nodiscard]] auto write_storage(std::span<std::byte const> bytes)
+		-> std::optional<ArenaAllocation>;
+
+	// makes the frame's writes visible to the GPU: flushes them, or records
+	// a copy from the staging Buffer. Must be recorded outside rendering,
+	// before any draws using the frame's allocations.
+	void commit(vk::CommandBuffer command_buffer) const;
+
+	[[nodiscard]] auto is_staged() const -> bool {
+		return m_staging.get().buffer != vk::Buffer{};
+	}
+
+	// range bytes from the start of the Buffer (the dynamic offset is
+	// added), at most the frame capacity: the Buffer has that much slack at
+	// the end, so that range past any offset is within bounds.
+	[[nodiscard]] auto descriptor_info(vk::DeviceSize range = vk::WholeSize)
+		const -> vk::DescriptorBufferInfo;
+
+	[[nodiscard]] auto get_frame_capacity() const -> vk::DeviceSize {
+		return m_frame_capacity;
+	}
+	[[nodiscard]] auto get_frame_used() const -> vk::DeviceSize {
+		return m_head - m_frame_begin;
+	}
+	[[nodiscard]] auto get_stats() const -> FrameArenaStats const& {
+		return m_stats;
+	}
+
+  private:
+	// Buffer that allocations are written to.
+	[[nodiscard]] auto get_mapped() const -> vma::RawBuffer const& {
+		return is_staged() ? m_staging.get() : m_buffer.get();
+	}
+
+	[[nodiscard]] auto reallocate(vk::DeviceSize frame_capacity) -> bool;
+	[[nodiscard]] auto should_shrink(vk::DeviceSize used) -> bool;
+	[[nodiscard]] auto scale(vk::DeviceSize size, float factor) const
+		-> vk::DeviceSize;
+
+	CreateInfo m_create_info{};
+	vma::Buffer m_buffer{};
+	// Host Buffer written to when m_buffer isn't host visible.
+	vma::Buffer m_staging{};
+	// both are aligned to max(uniform, storage alignment).
+	vk::DeviceSize m_frame_capacity{};
+	vk::DeviceSize m_min_capacity{};
+	vk::DeviceSize m_reserved{};
+	vk::DeviceSize m_alignment{};
+
+	vk::DeviceSize m_frame_begin{};
+	vk::DeviceSize m_head{};
+	// bytes the current frame needed, including failed allocations.
+	vk::DeviceSize m_demand{};
+	// consecutive frames below the shrink threshold.
+	std::uint32_t m_low_frames{};
+	FrameArenaStats m_stats{};
+};
+} // namespace lvk
@@ -0,0 +1,54 @@
+#include <free_list.hpp>
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace lvk {
+FreeList::FreeList(std::uint64_t const capacity) : m_capacity(capacity) {
+	if (capacity > 0) { m_free.emplace(0, capacity); }
+}
+
+auto FreeList::allocate(std::uint64_t const size)
+	-> std::optional<std::uint64_t> {
+	if (size == 0) { return {}; }
+	auto const it = std::ranges::find_if(
+		m_free, [size](auto const& range) { return range.second >= size; });
+	if (it == m_free.end()) { return {}; }
+
+	auto const [offset, free_size] = *it;
+	m_free.erase(it);
+	// return the remainder to the list.
+	if (free_size > size) { m_free.emplace(offset + size, free_size - size); }
+	m_used += size;
+	return offset;
+}
+
+void FreeList::free(std::uint64_t offset, std::uint64_t size) {
+	if (size == 0) { return; }
+	assert(offset + size <= m_capacity && size <= m_used);
+	m_used -= size;
+
+	auto next = m_free.lower_bound(offset);
+	// merge with the preceding free range if adjacent.
+	if (next != m_free.begin()) {
+		auto const prev = std::prev(next);
+		if (prev->first + prev->second == offset) {
+			offset = prev->first;
+			size += prev->second;
+			m_free.erase(prev);
+		}
+	}
+	// merge with the following free range if adjacent.
+	if (next != m_free.end() && offset + size == next->first) {
+		size += next->second;
+		m_free.erase(next);
+	}
+	m_free.emplace(offset, size);
+}
+
+auto FreeList::get_largest_free() const -> std::uint64_t {
+	auto ret = std::uint64_t{};
+	for (auto const& [offset, size] : m_free) { ret = std::max(ret, size); }
+	return ret;
+}
+} // namespace lvk
@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace lvk {
+// First-fit allocator of ranges within [0, capacity), free ranges are
+// coalesced with their neighbours. Only tracks offsets: the memory itself
+// lives elsewhere.
+class FreeList {
+  public:
+	explicit FreeList(std::uint64_t capacity);
+
+	// returns nullopt if no free range is large enough.
+	[[nodiscard]] auto allocate(std::uint64_t size)
+		-> std::optional<std::uint64_t>;
+	// offset and size must match a previous allocation.
+	void free(std::uint64_t offset, std::uint64_t size);
+
+	[[nodiscard]] auto get_capacity() const -> std::uint64_t {
+		return m_capacity;
+	}
+	[[nodiscard]] auto get_used() const -> std::uint64_t { return m_used; }
+	// size of the largest allocation that can succeed right now.
+	[[nodiscard]] auto get_largest_free() const -> std::uint64_t;
+
+  private:
+	std::uint64_t m_capacity{};
+	std::uint64_t m_used{};
+	// offset => size.
+	std::map<std::uint64_t, std::uint64_t> m_free{};
+};
+} // namespace lvk
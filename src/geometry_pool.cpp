@@ -0,0 +1,107 @@
+#include <geometry_pool.hpp>
+#include <spdlog/spdlog.h>
+#include <array>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+template <typename Type>
+[[nodiscard]] auto to_bytes(std::span<Type const> const span) {
+	void const* data = span.data();
+	return std::span{static_cast<std::byte const*>(data), span.size_bytes()};
+}
+} // namespace
+
+GeometryPool::GeometryPool(CreateInfo const& create_info)
+	: m_index_offset(vk::DeviceSize{create_info.vertex_capacity} *
+					 sizeof(Vertex)),
+	  m_vertices(create_info.vertex_capacity),
+	  m_indices(create_info.index_capacity) {
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = create_info.allocator,
+		// TransferSrc: the Buffer can be moved by copying.
+		.usage = vk::BufferUsageFlagBits::eVertexBuffer |
+				 vk::BufferUsageFlagBits::eIndexBuffer |
+				 vk::BufferUsageFlagBits::eTransferSrc,
+		.queue_family = create_info.queue_family,
+	};
+	// index region follows the vertex region, sizeof(Vertex) is a multiple of
+	// 4 so indices are suitably aligned.
+	static_assert(sizeof(Vertex) % sizeof(std::uint32_t) == 0);
+	auto const index_bytes =
+		vk::DeviceSize{create_info.index_capacity} * sizeof(std::uint32_t);
+	m_buffer = vma::create_buffer(buffer_ci, vma::BufferMemoryType::Device,
+								  m_index_offset + index_bytes);
+	if (!m_buffer.get().buffer) {
+		throw std::runtime_error{"Failed to create geometry pool Buffer"};
+	}
+}
+
+auto GeometryPool::add_mesh(UploadBatch& batch,
+							std::span<Vertex const> const vertices,
+							std::span<std::uint32_t const> const indices)
+	-> std::optional<GeometryHandle> {
+	auto const vertex_offset = m_vertices.allocate(vertices.size());
+	if (!vertex_offset) {
+		spdlog::error("[GeometryPool] Out of vertex space ({} vertices)",
+					  vertices.size());
+		return {};
+	}
+	auto const first_index = m_indices.allocate(indices.size());
+	if (!first_index) {
+		spdlog::error("[GeometryPool] Out of index space ({} indices)",
+					  indices.size());
+		m_vertices.free(*vertex_offset, vertices.size());
+		return {};
+	}
+
+	auto const ret = GeometryHandle{
+		.vertex_offset = static_cast<std::int32_t>(*vertex_offset),
+		.vertex_count = static_cast<std::uint32_t>(vertices.size()),
+		.first_index = static_cast<std::uint32_t>(*first_index),
+		.index_count = static_cast<std::uint32_t>(indices.size()),
+	};
+	// both ranges are written or neither: a failed index write must not
+	// leave a vertex copy pending into freed ranges.
+	auto const buffer = m_buffer.get().buffer;
+	auto const writes = std::array{
+		BufferWrite{
+			.dst = buffer,
+			.offset = *vertex_offset * sizeof(Vertex),
+			.bytes = to_bytes(vertices),
+		},
+		BufferWrite{
+			.dst = buffer,
+			.offset = m_index_offset + *first_index * sizeof(std::uint32_t),
+			.bytes = to_bytes(indices),
+		},
+	};
+	if (!batch.write_buffers(writes)) {
+		remove_mesh(ret);
+		return {};
+	}
+	return ret;
+}
+
+void GeometryPool::remove_mesh(GeometryHandle const& handle) {
+	m_vertices.free(static_cast<std::uint64_t>(handle.vertex_offset),
+					handle.vertex_count);
+	m_indices.free(handle.first_index, handle.index_count);
+}
+
+void GeometryPool::bind(vk::CommandBuffer const command_buffer) const {
+	command_buffer.bindVertexBuffers(0, m_buffer.get().buffer,
+									 vk::DeviceSize{});
+	command_buffer.bindIndexBuffer(m_buffer.get().buffer, m_index_offset,
+								   vk::IndexType::eUint32);
+}
+
+void GeometryPool::draw(vk::CommandBuffer const command_buffer,
+						GeometryHandle const& handle,
+						std::uint32_t const instance_count,
+						std::uint32_t const first_instance) const {
+	command_buffer.drawIndexed(handle.index_count, instance_count,
+							   handle.first_index, handle.vertex_offset,
+							   first_instance);
+}
+} // namespace lvk
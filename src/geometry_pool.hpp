@@ -0,0 +1,70 @@
+#pragma once
+#include <free_list.hpp>
+#include <upload_batch.hpp>
+#include <vertex.hpp>
+#include <vma.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace lvk {
+// Location of a mesh within a GeometryPool, passed as base offsets to
+// drawIndexed().
+struct GeometryHandle {
+	std::int32_t vertex_offset{};
+	std::uint32_t vertex_count{};
+	std::uint32_t first_index{};
+	std::uint32_t index_count{};
+};
+
+struct GeometryPoolCreateInfo {
+	VmaAllocator allocator;
+	std::uint32_t queue_family;
+	std::uint32_t vertex_capacity{64 * 1024};
+	std::uint32_t index_capacity{256 * 1024};
+};
+
+// One Device Buffer holding the vertices and (u32) indices of many meshes,
+// sub-allocated through free lists. All meshes are drawn after a single
+// bind() with their handles' base offsets.
+class GeometryPool {
+  public:
+	using CreateInfo = GeometryPoolCreateInfo;
+
+	explicit GeometryPool(CreateInfo const& create_info);
+
+	// stages vertices and indices into batch, usable on the GPU once its
+	// ticket is signalled. indices are relative to the mesh's vertices.
+	// returns nullopt if the pool (or staging memory) is out of space.
+	[[nodiscard]] auto add_mesh(UploadBatch& batch,
+								std::span<Vertex const> vertices,
+								std::span<std::uint32_t const> indices)
+		-> std::optional<GeometryHandle>;
+	// the mesh must not be in use by the GPU anymore.
+	void remove_mesh(GeometryHandle const& handle);
+
+	// binds the vertex Buffer at binding 0 and the index Buffer.
+	void bind(vk::CommandBuffer command_buffer) const;
+	void draw(vk::CommandBuffer command_buffer, GeometryHandle const& handle,
+			  std::uint32_t instance_count,
+			  std::uint32_t first_instance = 0) const;
+
+	// for the Defragmenter to move the Buffer in place.
+	[[nodiscard]] auto get_buffer() -> vma::Buffer& { return m_buffer; }
+
+	[[nodiscard]] auto get_vertices() const -> FreeList const& {
+		return m_vertices;
+	}
+	[[nodiscard]] auto get_indices() const -> FreeList const& {
+		return m_indices;
+	}
+
+  private:
+	vma::Buffer m_buffer{};
+	// byte offset of the index region.
+	vk::DeviceSize m_index_offset{};
+	// allocated in units of vertices / indices.
+	FreeList m_vertices;
+	FreeList m_indices;
+};
+} // namespace lvk
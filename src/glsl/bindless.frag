@@ -0,0 +1,16 @@
+#version 450 core
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout (set = 1, binding = 0) uniform sampler2D textures[];
+
+layout (location = 0) in vec3 in_color;
+layout (location = 1) in vec2 in_uv;
+layout (location = 2) flat in uint in_texture;
+
+layout (location = 0) out vec4 out_color;
+
+void main() {
+	// instances of one draw may use different textures.
+	const vec4 texel = texture(textures[nonuniformEXT(in_texture)], in_uv);
+	out_color = vec4(in_color, 1.0) * texel;
+}
@@ -0,0 +1,38 @@
+#version 450 core
+
+layout (location = 0) in vec2 a_pos;
+layout (location = 1) in vec3 a_color;
+layout (location = 2) in vec2 a_uv;
+
+layout (set = 0, binding = 0) uniform View {
+	mat4 mat_vp;
+};
+
+layout (set = 2, binding = 0) readonly buffer Instances {
+	mat4 mat_ms[];
+};
+
+// index into the bindless texture array, per instance.
+layout (set = 2, binding = 1) readonly buffer TextureIndices {
+	uint texture_indices[];
+};
+
+// UV offset (xy) and scale (zw) per instance, into its texture (atlas page).
+layout (set = 2, binding = 2) readonly buffer UvRects {
+	vec4 uv_rects[];
+};
+
+layout (location = 0) out vec3 out_color;
+layout (location = 1) out vec2 out_uv;
+layout (location = 2) flat out uint out_texture;
+
+void main() {
+	const mat4 mat_m = mat_ms[gl_InstanceIndex];
+	const vec4 world_pos = mat_m * vec4(a_pos, 0.0, 1.0);
+
+	out_color = a_color;
+	const vec4 uv_rect = uv_rects[gl_InstanceIndex];
+	out_uv = uv_rect.xy + a_uv * uv_rect.zw;
+	out_texture = texture_indices[gl_InstanceIndex];
+	gl_Position = mat_vp * world_pos;
+}
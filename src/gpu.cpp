@@ -5,17 +5,19 @@
 
 auto lvk::get_suitable_gpu(vk::Instance const instance,
 						   vk::SurfaceKHR const surface) -> Gpu {
-	auto const supports_swapchain = [](Gpu const& gpu) {
-		static constexpr std::string_view name_v =
-			VK_KHR_SWAPCHAIN_EXTENSION_NAME;
-		static constexpr auto is_swapchain =
-			[](vk::ExtensionProperties const& properties) {
-				return properties.extensionName.data() == name_v;
+	auto const supports_extension = [](Gpu const& gpu,
+									   std::string_view const name) {
+		auto const is_extension =
+			[name](vk::ExtensionProperties const& properties) {
+				return properties.extensionName.data() == name;
 			};
 		auto const properties = gpu.device.enumerateDeviceExtensionProperties();
-		auto const it = std::ranges::find_if(properties, is_swapchain);
+		auto const it = std::ranges::find_if(properties, is_extension);
 		return it != properties.end();
 	};
+	auto const supports_swapchain = [&supports_extension](Gpu const& gpu) {
+		return supports_extension(gpu, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+	};
 
 	auto const set_queue_family = [](Gpu& out_gpu) {
 		static constexpr auto queue_flags_v =
@@ -30,7 +32,49 @@ auto lvk::get_suitable_gpu(vk::Instance const instance,
 		return false;
 	};
 
+	auto const set_transfer_family = [](Gpu& out_gpu) {
+		static constexpr auto excluded_v =
+			vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute;
+		for (auto const [index, family] :
+			 std::views::enumerate(out_gpu.device.getQueueFamilyProperties())) {
+			if ((family.queueFlags & vk::QueueFlagBits::eTransfer) &&
+				!(family.queueFlags & excluded_v)) {
+				out_gpu.transfer_family = static_cast<std::uint32_t>(index);
+				return;
+			}
+		}
+	};
+
+	auto const set_descriptor_indexing = [](Gpu& out_gpu) {
+		auto const features = out_gpu.device.getFeatures2<
+			vk::PhysicalDeviceFeatures2,
+			vk::PhysicalDeviceDescriptorIndexingFeatures>();
+		auto const& indexing =
+			features.get<vk::PhysicalDeviceDescriptorIndexingFeatures>();
+		out_gpu.descriptor_indexing =
+			indexing.runtimeDescriptorArray == vk::True &&
+			indexing.descriptorBindingPartiallyBound == vk::True &&
+			indexing.descriptorBindingSampledImageUpdateAfterBind ==
+				vk::True &&
+			indexing.descriptorBindingUpdateUnusedWhilePending == vk::True &&
+			indexing.shaderSampledImageArrayNonUniformIndexing == vk::True;
+		auto const properties = out_gpu.device.getProperties2<
+			vk::PhysicalDeviceProperties2,
+			vk::PhysicalDeviceDescriptorIndexingProperties>();
+		auto const& limits =
+			properties.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+		// combined image samplers count as both samplers and sampled images.
+		out_gpu.max_bindless_textures = std::min({
+			limits.maxDescriptorSetUpdateAfterBindSamplers,
+			limits.maxDescriptorSetUpdateAfterBindSampledImages,
+			limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+			limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		});
+	};
+
 	auto const can_present = [surface](Gpu const& gpu) {
+		// headless: no presentation support required.
+		if (!surface) { return true; }
 		return gpu.device.getSurfaceSupportKHR(gpu.queue_family, surface) ==
 			   vk::True;
 	};
@@ -39,10 +83,14 @@ auto lvk::get_suitable_gpu(vk::Instance const instance,
 	for (auto const& device : instance.enumeratePhysicalDevices()) {
 		auto gpu = Gpu{.device = device, .properties = device.getProperties()};
 		if (gpu.properties.apiVersion < vk_version_v) { continue; }
-		if (!supports_swapchain(gpu)) { continue; }
+		if (surface && !supports_swapchain(gpu)) { continue; }
 		if (!set_queue_family(gpu)) { continue; }
 		if (!can_present(gpu)) { continue; }
 		gpu.features = gpu.device.getFeatures();
+		set_transfer_family(gpu);
+		set_descriptor_indexing(gpu);
+		gpu.memory_budget =
+			supports_extension(gpu, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 		if (gpu.properties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu) {
 			return gpu;
 		}
@@ -1,5 +1,6 @@
 #pragma once
 #include <vulkan/vulkan.hpp>
+#include <optional>
 
 namespace lvk {
 constexpr auto vk_version_v = VK_MAKE_VERSION(1, 3, 0);
@@ -9,8 +10,19 @@ struct Gpu {
 	vk::PhysicalDeviceProperties properties{};
 	vk::PhysicalDeviceFeatures features{};
 	std::uint32_t queue_family{};
+	// transfer-only queue family (usually DMA engines), if any.
+	std::optional<std::uint32_t> transfer_family{};
+	// VK_EXT_memory_budget is supported.
+	bool memory_budget{};
+	// descriptor indexing features for bindless textures are supported:
+	// partially bound, update after bind (and unused while pending) runtime
+	// arrays of sampled images, indexed non-uniformly.
+	bool descriptor_indexing{};
+	// combined image samplers an update after bind set / stage can hold.
+	std::uint32_t max_bindless_textures{};
 };
 
+// pass a null surface to skip Swapchain and presentation checks (headless).
 [[nodiscard]] auto get_suitable_gpu(vk::Instance instance,
 									vk::SurfaceKHR surface) -> Gpu;
 } // namespace lvk
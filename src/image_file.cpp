@@ -0,0 +1,54 @@
+#include <image_file.hpp>
+#include <mapped_file.hpp>
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+#include <limits>
+
+namespace lvk {
+namespace {
+constexpr int channels_v{4};
+} // namespace
+
+auto RawImageFile::bitmap() const -> Bitmap {
+	auto const count = static_cast<std::size_t>(size.x) *
+					   static_cast<std::size_t>(size.y) * channels_v;
+	return Bitmap{.bytes = {pixels, count}, .size = size};
+}
+
+void ImageFileDeleter::operator()(
+	RawImageFile const& raw_image_file) const noexcept {
+	stbi_image_free(raw_image_file.pixels);
+}
+
+auto decode_image(std::span<std::byte const> compressed) -> ImageFile {
+	static constexpr auto max_size_v =
+		static_cast<std::size_t>(std::numeric_limits<int>::max());
+	if (compressed.empty() || compressed.size() > max_size_v) { return {}; }
+	auto size = glm::ivec2{};
+	auto channels = int{};
+	auto const* data = reinterpret_cast<stbi_uc const*>(compressed.data());
+	auto* const pixels =
+		stbi_load_from_memory(data, static_cast<int>(compressed.size()),
+							  &size.x, &size.y, &channels, channels_v);
+	if (pixels == nullptr) {
+		spdlog::error("[lvk] Failed to decode image: {}",
+					  stbi_failure_reason());
+		return {};
+	}
+	return RawImageFile{
+		.pixels = reinterpret_cast<std::byte*>(pixels),
+		.size = size,
+	};
+}
+
+auto load_image(fs::path const& path) -> ImageFile {
+	auto const file = map_file(path);
+	if (file.get().data == nullptr) { return {}; }
+	auto ret = decode_image(file.get().bytes());
+	if (ret.get().pixels == nullptr) {
+		spdlog::error("[lvk] Failed to load image: '{}'",
+					  path.generic_string());
+	}
+	return ret;
+}
+} // namespace lvk
@@ -0,0 +1,33 @@
+#pragma once
+#include <bitmap.hpp>
+#include <scoped.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace lvk {
+namespace fs = std::filesystem;
+
+// RGBA8 pixels decoded by stb_image.
+struct RawImageFile {
+	auto operator==(RawImageFile const& rhs) const -> bool = default;
+
+	[[nodiscard]] auto bitmap() const -> Bitmap;
+
+	std::byte* pixels{};
+	glm::ivec2 size{};
+};
+
+struct ImageFileDeleter {
+	void operator()(RawImageFile const& raw_image_file) const noexcept;
+};
+
+using ImageFile = Scoped<RawImageFile, ImageFileDeleter>;
+
+// decodes a PNG / JPEG (or any other format stb_image supports) into RGBA8.
+// thread-safe. returns an empty ImageFile on failure.
+[[nodiscard]] auto decode_image(std::span<std::byte const> compressed)
+	-> ImageFile;
+// maps the file at path and decodes it, as above.
+[[nodiscard]] auto load_image(fs::path const& path) -> ImageFile;
+} // namespace lvk
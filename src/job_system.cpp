@@ -0,0 +1,170 @@
+#include <spdlog/spdlog.h>
+#include <job_system.hpp>
+#include <utility>
+
+namespace lvk {
+namespace {
+// JobSystem and queue owned by the current worker thread, if any.
+thread_local JobSystem const* t_owner{};
+thread_local std::size_t t_queue{};
+} // namespace
+
+auto JobSystem::default_worker_count() -> std::size_t {
+	auto const hardware_threads = std::thread::hardware_concurrency();
+	if (hardware_threads < 2) { return 0; }
+	return hardware_threads - 1;
+}
+
+JobSystem::JobSystem(std::size_t const worker_count)
+	: m_queues(worker_count + 1) {
+	m_workers.reserve(worker_count);
+	for (auto i = std::size_t{0}; i < worker_count; ++i) {
+		m_workers.emplace_back([this, i] { work(i + 1); });
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		auto lock = std::scoped_lock{m_sleep_mutex};
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	m_workers.clear();
+	// run any jobs left over (eg if there are no workers).
+	while (try_run_one(0)) {}
+}
+
+void JobSystem::submit(Task task, JobCounter* const counter) {
+	if (counter != nullptr) {
+		counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	push(Job{.task = std::move(task), .counter = counter});
+}
+
+void JobSystem::submit_after(JobCounter& dependency, Task task,
+							 JobCounter* const counter) {
+	if (counter != nullptr) {
+		counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	{
+		// the dependency's pending count is decremented under its lock.
+		auto lock = std::scoped_lock{dependency.m_mutex};
+		if (!dependency.is_done()) {
+			dependency.m_continuations.push_back(
+				JobCounter::Continuation{.task = std::move(task),
+										 .counter = counter});
+			return;
+		}
+	}
+	push(Job{.task = std::move(task), .counter = counter});
+}
+
+void JobSystem::wait(JobCounter& counter) {
+	auto const index = current_queue();
+	while (!counter.is_done()) {
+		// help while waiting.
+		if (!try_run_one(index)) { std::this_thread::yield(); }
+	}
+	// synchronize with the last finish(), which may still hold the lock.
+	auto lock = std::scoped_lock{counter.m_mutex};
+	if (counter.m_exception) {
+		auto const exception = std::exchange(counter.m_exception, {});
+		std::rethrow_exception(exception);
+	}
+}
+
+void JobSystem::work(std::size_t const index) {
+	t_owner = this;
+	t_queue = index;
+	while (true) {
+		if (try_run_one(index)) { continue; }
+		auto lock = std::unique_lock{m_sleep_mutex};
+		m_wake.wait(lock, [this] {
+			return m_stop || m_queued.load(std::memory_order_acquire) > 0;
+		});
+		if (m_stop && m_queued.load(std::memory_order_acquire) == 0) {
+			return;
+		}
+	}
+}
+
+void JobSystem::push(Job job) {
+	auto& queue = m_queues.at(current_queue());
+	{
+		auto lock = std::scoped_lock{queue.mutex};
+		queue.jobs.push_back(std::move(job));
+	}
+	m_queued.fetch_add(1, std::memory_order_release);
+	// prevent a lost wakeup between a worker's check and its wait.
+	{ auto lock = std::scoped_lock{m_sleep_mutex}; }
+	m_wake.notify_one();
+}
+
+auto JobSystem::try_run_one(std::size_t const index) -> bool {
+	auto job = try_pop(index);
+	if (!job) { return false; }
+	auto exception = std::exception_ptr{};
+	try {
+		job->task();
+	} catch (...) { exception = std::current_exception(); }
+	if (job->counter != nullptr) {
+		finish(*job->counter, exception);
+	} else if (exception) {
+		// no one to rethrow it to.
+		try {
+			std::rethrow_exception(exception);
+		} catch (std::exception const& e) {
+			spdlog::error("[JobSystem] Unhandled exception: {}", e.what());
+		} catch (...) { spdlog::error("[JobSystem] Unhandled exception"); }
+	}
+	return true;
+}
+
+auto JobSystem::try_pop(std::size_t const index) -> std::optional<Job> {
+	if (m_queued.load(std::memory_order_acquire) == 0) { return {}; }
+	auto const take = [this](Queue& queue, bool const own) {
+		auto lock = std::scoped_lock{queue.mutex};
+		auto ret = std::optional<Job>{};
+		if (queue.jobs.empty()) { return ret; }
+		// own jobs are popped LIFO (cache-warm), stolen jobs FIFO.
+		if (own) {
+			ret = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		} else {
+			ret = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+		m_queued.fetch_sub(1, std::memory_order_acq_rel);
+		return ret;
+	};
+	if (auto ret = take(m_queues.at(index), true)) { return ret; }
+	for (auto i = std::size_t{1}; i < m_queues.size(); ++i) {
+		auto& victim = m_queues.at((index + i) % m_queues.size());
+		if (auto ret = take(victim, false)) { return ret; }
+	}
+	return {};
+}
+
+void JobSystem::finish(JobCounter& counter,
+					   std::exception_ptr const exception) {
+	auto continuations = std::vector<JobCounter::Continuation>{};
+	{
+		auto lock = std::scoped_lock{counter.m_mutex};
+		if (exception && !counter.m_exception) {
+			counter.m_exception = exception;
+		}
+		if (counter.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			continuations = std::exchange(counter.m_continuations, {});
+		}
+	}
+	// counter may be destroyed by now.
+	for (auto& continuation : continuations) {
+		push(Job{.task = std::move(continuation.task),
+				 .counter = continuation.counter});
+	}
+}
+
+auto JobSystem::current_queue() const -> std::size_t {
+	return t_owner == this ? t_queue : 0;
+}
+} // namespace lvk
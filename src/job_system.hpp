@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace lvk {
+// Counts outstanding jobs: incremented on submit, decremented on completion.
+// Other jobs can be scheduled to run once it reaches zero.
+class JobCounter {
+  public:
+	JobCounter() = default;
+
+	JobCounter(JobCounter const&) = delete;
+	JobCounter(JobCounter&&) = delete;
+	auto operator=(JobCounter const&) = delete;
+	auto operator=(JobCounter&&) = delete;
+
+	~JobCounter() = default;
+
+	[[nodiscard]] auto is_done() const -> bool {
+		return m_pending.load(std::memory_order_acquire) == 0;
+	}
+
+  private:
+	struct Continuation {
+		std::function<void()> task{};
+		JobCounter* counter{};
+	};
+
+	std::atomic<std::size_t> m_pending{};
+	std::mutex m_mutex{};
+	std::vector<Continuation> m_continuations{};
+	// first exception thrown by a job, rethrown by JobSystem::wait().
+	std::exception_ptr m_exception{};
+
+	friend class JobSystem;
+};
+
+// Work-stealing scheduler: each thread owns a deque of jobs, pops its own
+// jobs LIFO and steals others' jobs FIFO when it runs out.
+class JobSystem {
+  public:
+	using Task = std::function<void()>;
+
+	// one less than the number of hardware threads, the submitting thread
+	// helps while waiting.
+	[[nodiscard]] static auto default_worker_count() -> std::size_t;
+
+	// worker_count may be 0, jobs are then run by waiting threads.
+	explicit JobSystem(std::size_t worker_count = default_worker_count());
+
+	JobSystem(JobSystem const&) = delete;
+	JobSystem(JobSystem&&) = delete;
+	auto operator=(JobSystem const&) = delete;
+	auto operator=(JobSystem&&) = delete;
+
+	// runs all remaining jobs before joining workers.
+	~JobSystem();
+
+	// counter (if not null) is decremented once task has run.
+	void submit(Task task, JobCounter* counter = nullptr);
+	// task is scheduled once dependency reaches zero.
+	void submit_after(JobCounter& dependency, Task task,
+					  JobCounter* counter = nullptr);
+
+	// runs pending jobs on the calling thread until counter reaches zero,
+	// then rethrows the first exception thrown by its jobs, if any.
+	void wait(JobCounter& counter);
+
+	// calls func(begin, end) over [0, count) in chunks of up to grain,
+	// the calling thread runs the first chunk and then helps.
+	template <typename Func>
+	void parallel_for(std::size_t count, std::size_t grain, Func const& func);
+
+	[[nodiscard]] auto get_worker_count() const -> std::size_t {
+		return m_workers.size();
+	}
+
+  private:
+	struct Job {
+		Task task{};
+		JobCounter* counter{};
+	};
+
+	struct Queue {
+		std::mutex mutex{};
+		std::deque<Job> jobs{};
+	};
+
+	void work(std::size_t index);
+	void push(Job job);
+	auto try_run_one(std::size_t index) -> bool;
+	[[nodiscard]] auto try_pop(std::size_t index) -> std::optional<Job>;
+	void finish(JobCounter& counter, std::exception_ptr exception);
+	[[nodiscard]] auto current_queue() const -> std::size_t;
+
+	// queue 0 is shared by all threads that are not workers.
+	std::vector<Queue> m_queues;
+	std::atomic<std::size_t> m_queued{};
+
+	std::mutex m_sleep_mutex{};
+	std::condition_variable m_wake{};
+	bool m_stop{};
+
+	// must be destroyed (joined) before the queues.
+	std::vector<std::jthread> m_workers{};
+};
+
+template <typename Func>
+void JobSystem::parallel_for(std::size_t const count, std::size_t grain,
+							 Func const& func) {
+	if (count == 0) { return; }
+	grain = std::max(grain, std::size_t{1});
+	auto const chunks = (count + grain - 1) / grain;
+	if (chunks == 1 || m_workers.empty()) {
+		func(std::size_t{0}, count);
+		return;
+	}
+
+	auto counter = JobCounter{};
+	for (auto i = std::size_t{1}; i < chunks; ++i) {
+		auto const begin = i * grain;
+		auto const end = std::min(begin + grain, count);
+		submit([&func, begin, end] { func(begin, end); }, &counter);
+	}
+	// counter must outlive the submitted jobs even if func throws.
+	auto exception = std::exception_ptr{};
+	try {
+		func(std::size_t{0}, grain);
+	} catch (...) { exception = std::current_exception(); }
+	wait(counter);
+	if (exception) { std::rethrow_exception(exception); }
+}
+} // namespace lvk
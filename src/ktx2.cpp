@@ -0,0 +1,242 @@
+#include <ktx2.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <format>
+#include <string_view>
+
+namespace lvk {
+namespace {
+constexpr auto identifier_v = std::array<std::uint8_t, 12>{
+	0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n',
+};
+
+// little-endian, as are all hosts this runs on.
+struct Header {
+	std::array<std::uint8_t, 12> identifier;
+	std::uint32_t vk_format;
+	std::uint32_t type_size;
+	std::uint32_t pixel_width;
+	std::uint32_t pixel_height;
+	std::uint32_t pixel_depth;
+	std::uint32_t layer_count;
+	std::uint32_t face_count;
+	std::uint32_t level_count;
+	std::uint32_t supercompression_scheme;
+	std::uint32_t dfd_byte_offset;
+	std::uint32_t dfd_byte_length;
+	std::uint32_t kvd_byte_offset;
+	std::uint32_t kvd_byte_length;
+	std::uint64_t sgd_byte_offset;
+	std::uint64_t sgd_byte_length;
+};
+static_assert(sizeof(Header) == 80);
+
+struct LevelIndex {
+	std::uint64_t byte_offset;
+	std::uint64_t byte_length;
+	std::uint64_t uncompressed_byte_length;
+};
+static_assert(sizeof(LevelIndex) == 24);
+
+[[nodiscard]] constexpr auto block_count(std::uint32_t const texels,
+										 std::uint32_t const block_texels) {
+	return std::size_t{(texels + block_texels - 1) / block_texels};
+}
+} // namespace
+
+auto get_format_block(vk::Format const format) -> std::optional<FormatBlock> {
+	using enum vk::Format;
+	auto const astc = [](std::uint32_t const width,
+						 std::uint32_t const height) {
+		return FormatBlock{.extent = {width, height}, .size = 16};
+	};
+	switch (format) {
+	case eR8G8B8A8Unorm:
+	case eR8G8B8A8Srgb:
+	case eB8G8R8A8Unorm:
+	case eB8G8R8A8Srgb: return FormatBlock{.size = 4};
+
+	case eBc1RgbUnormBlock:
+	case eBc1RgbSrgbBlock:
+	case eBc1RgbaUnormBlock:
+	case eBc1RgbaSrgbBlock:
+	case eBc4UnormBlock:
+	case eBc4SnormBlock:
+	case eEtc2R8G8B8UnormBlock:
+	case eEtc2R8G8B8SrgbBlock:
+	case eEtc2R8G8B8A1UnormBlock:
+	case eEtc2R8G8B8A1SrgbBlock:
+	case eEacR11UnormBlock:
+	case eEacR11SnormBlock: return FormatBlock{.extent = {4, 4}, .size = 8};
+
+	case eBc2UnormBlock:
+	case eBc2SrgbBlock:
+	case eBc3UnormBlock:
+	case eBc3SrgbBlock:
+	case eBc5UnormBlock:
+	case eBc5SnormBlock:
+	case eBc6HUfloatBlock:
+	case eBc6HSfloatBlock:
+	case eBc7UnormBlock:
+	case eBc7SrgbBlock:
+	case eEtc2R8G8B8A8UnormBlock:
+	case eEtc2R8G8B8A8SrgbBlock:
+	case eEacR11G11UnormBlock:
+	case eEacR11G11SnormBlock: return FormatBlock{.extent = {4, 4}, .size = 16};
+
+	case eAstc4x4UnormBlock:
+	case eAstc4x4SrgbBlock: return astc(4, 4);
+	case eAstc5x4UnormBlock:
+	case eAstc5x4SrgbBlock: return astc(5, 4);
+	case eAstc5x5UnormBlock:
+	case eAstc5x5SrgbBlock: return astc(5, 5);
+	case eAstc6x5UnormBlock:
+	case eAstc6x5SrgbBlock: return astc(6, 5);
+	case eAstc6x6UnormBlock:
+	case eAstc6x6SrgbBlock: return astc(6, 6);
+	case eAstc8x5UnormBlock:
+	case eAstc8x5SrgbBlock: return astc(8, 5);
+	case eAstc8x6UnormBlock:
+	case eAstc8x6SrgbBlock: return astc(8, 6);
+	case eAstc8x8UnormBlock:
+	case eAstc8x8SrgbBlock: return astc(8, 8);
+	case eAstc10x5UnormBlock:
+	case eAstc10x5SrgbBlock: return astc(10, 5);
+	case eAstc10x6UnormBlock:
+	case eAstc10x6SrgbBlock: return astc(10, 6);
+	case eAstc10x8UnormBlock:
+	case eAstc10x8SrgbBlock: return astc(10, 8);
+	case eAstc10x10UnormBlock:
+	case eAstc10x10SrgbBlock: return astc(10, 10);
+	case eAstc12x10UnormBlock:
+	case eAstc12x10SrgbBlock: return astc(12, 10);
+	case eAstc12x12UnormBlock:
+	case eAstc12x12SrgbBlock: return astc(12, 12);
+
+	default: return {};
+	}
+}
+
+auto supports_sampled_upload(vk::PhysicalDevice const physical_device,
+							 vk::Format const format) -> bool {
+	static constexpr auto features_v = vk::FormatFeatureFlagBits::eTransferDst |
+									   vk::FormatFeatureFlagBits::eSampledImage;
+	auto const properties = physical_device.getFormatProperties(format);
+	return (properties.optimalTilingFeatures & features_v) == features_v;
+}
+
+auto Ktx2::load(fs::path const& path) -> std::optional<Ktx2> {
+	auto const fail = [&path](std::string_view const reason) {
+		spdlog::error("[Ktx2] {}: '{}'", reason, path.generic_string());
+		return std::nullopt;
+	};
+
+	auto ret = Ktx2{};
+	ret.m_file = map_file(path);
+	auto const bytes = ret.m_file.get().bytes();
+	if (bytes.empty()) { return std::nullopt; }
+
+	auto header = Header{};
+	if (bytes.size() < sizeof(header)) { return fail("Truncated header"); }
+	std::memcpy(&header, bytes.data(), sizeof(header));
+	if (header.identifier != identifier_v) { return fail("Not a KTX2 file"); }
+	if (header.supercompression_scheme != 0) {
+		return fail("Supercompressed textures are not supported");
+	}
+	if (header.pixel_depth > 1 || header.face_count != 1 ||
+		header.pixel_height == 0) {
+		return fail("Only 2D (array) textures are supported");
+	}
+	ret.m_format = static_cast<vk::Format>(header.vk_format);
+	auto const block = get_format_block(ret.m_format);
+	if (!block) {
+		return fail(std::format("Unsupported format ({})",
+								vk::to_string(ret.m_format)));
+	}
+	if (header.pixel_width == 0) { return fail("Invalid extent"); }
+	ret.m_extent = vk::Extent2D{header.pixel_width, header.pixel_height};
+	ret.m_layers = std::max(header.layer_count, 1u);
+
+	// 0 requests mip generation at load time, which is not done here: only
+	// the base level is uploaded.
+	auto const level_count = std::max(header.level_count, 1u);
+	// a full chain ends at 1x1: further levels would shift extents by 32
+	// or more.
+	auto const max_levels = static_cast<std::uint32_t>(std::bit_width(
+		std::max(ret.m_extent.width, ret.m_extent.height)));
+	if (level_count > max_levels) {
+		return fail(std::format("Invalid level count ({})", level_count));
+	}
+	auto const level_index_size = std::size_t{level_count} * sizeof(LevelIndex);
+	if (bytes.size() - sizeof(header) < level_index_size) {
+		return fail("Truncated level index");
+	}
+
+	// levels are stored smallest first: the payload spans from the last
+	// level to the end of the base level.
+	ret.m_levels.reserve(level_count);
+	auto payload_begin = bytes.size();
+	auto payload_end = 0uz;
+	for (auto level = 0u; level < level_count; ++level) {
+		auto index = LevelIndex{};
+		std::memcpy(&index,
+					bytes.data() + sizeof(header) + level * sizeof(index),
+					sizeof(index));
+		auto const extent = vk::Extent2D{
+			std::max(ret.m_extent.width >> level, 1u),
+			std::max(ret.m_extent.height >> level, 1u),
+		};
+		auto const expected_size =
+			block_count(extent.width, block->extent.width) *
+			block_count(extent.height, block->extent.height) * block->size *
+			ret.m_layers;
+		if (index.byte_length != expected_size ||
+			index.byte_offset > bytes.size() ||
+			bytes.size() - index.byte_offset < index.byte_length) {
+			return fail(std::format("Invalid level {}", level));
+		}
+		auto const offset = static_cast<std::size_t>(index.byte_offset);
+		payload_begin = std::min(payload_begin, offset);
+		payload_end = std::max(payload_end, offset + expected_size);
+		ret.m_levels.push_back(Ktx2Level{
+			.extent = extent,
+			.offset = offset,
+			.size = expected_size,
+		});
+	}
+
+	// level offsets are aligned to lcm(block size, 4) in the file: relative
+	// to the payload they satisfy buffer image copy offset requirements.
+	for (auto& level : ret.m_levels) { level.offset -= payload_begin; }
+	ret.m_payload = bytes.subspan(payload_begin, payload_end - payload_begin);
+	return ret;
+}
+
+auto Ktx2::select(vk::PhysicalDevice const physical_device,
+				  std::span<fs::path const> candidates)
+	-> std::optional<Ktx2> {
+	auto const max_layers =
+		physical_device.getProperties().limits.maxImageArrayLayers;
+	for (auto const& path : candidates) {
+		auto ret = load(path);
+		if (!ret) { continue; }
+		if (ret->get_layers() > max_layers) {
+			spdlog::error("[Ktx2] Too many layers for GPU ({} > {}): '{}'",
+						  ret->get_layers(), max_layers,
+						  path.generic_string());
+			continue;
+		}
+		if (supports_sampled_upload(physical_device, ret->get_format())) {
+			return ret;
+		}
+		spdlog::info("[Ktx2] Format not supported by GPU ({}): '{}'",
+					 vk::to_string(ret->get_format()), path.generic_string());
+	}
+	spdlog::error("[Ktx2] No supported texture among {} candidate(s)",
+				  candidates.size());
+	return std::nullopt;
+}
+} // namespace lvk
@@ -0,0 +1,67 @@
+#pragma once
+#include <mapped_file.hpp>
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lvk {
+// Texel block of a format: 1x1 for uncompressed formats.
+struct FormatBlock {
+	vk::Extent2D extent{1, 1};
+	std::uint32_t size{};
+};
+
+// returns nullopt for formats Ktx2 does not load.
+[[nodiscard]] auto get_format_block(vk::Format format)
+	-> std::optional<FormatBlock>;
+
+// format can be uploaded to and sampled (optimal tiling).
+[[nodiscard]] auto supports_sampled_upload(vk::PhysicalDevice physical_device,
+										   vk::Format format) -> bool;
+
+struct Ktx2Level {
+	vk::Extent2D extent{};
+	// into Ktx2::get_payload(), covers all layers.
+	std::size_t offset{};
+	std::size_t size{};
+};
+
+// Memory mapped KTX2 texture: 2D (array) images of BCn / ETC2 / EAC / ASTC
+// or RGBA8 formats, without supercompression.
+// The payload is a single range of the mapping containing every level, to
+// be copied straight into staging memory.
+class Ktx2 {
+  public:
+	// returns nullopt (and logs an error) if the file cannot be loaded.
+	[[nodiscard]] static auto load(fs::path const& path)
+		-> std::optional<Ktx2>;
+	// loads the first of candidates (eg BC7, ASTC and ETC2 encodings of the
+	// same texture) whose format and layer count physical_device supports.
+	[[nodiscard]] static auto select(vk::PhysicalDevice physical_device,
+									 std::span<fs::path const> candidates)
+		-> std::optional<Ktx2>;
+
+	[[nodiscard]] auto get_format() const -> vk::Format { return m_format; }
+	[[nodiscard]] auto get_extent() const -> vk::Extent2D { return m_extent; }
+	[[nodiscard]] auto get_layers() const -> std::uint32_t { return m_layers; }
+	// level 0 (the base level) first.
+	[[nodiscard]] auto get_levels() const -> std::span<Ktx2Level const> {
+		return m_levels;
+	}
+	[[nodiscard]] auto get_payload() const -> std::span<std::byte const> {
+		return m_payload;
+	}
+
+  private:
+	Ktx2() = default;
+
+	MappedFile m_file{};
+	vk::Format m_format{};
+	vk::Extent2D m_extent{};
+	std::uint32_t m_layers{};
+	std::vector<Ktx2Level> m_levels{};
+	std::span<std::byte const> m_payload{};
+};
+} // namespace lvk
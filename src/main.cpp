@@ -1,8 +1,34 @@
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
 #include <app.hpp>
+#include <benchmark.hpp>
+#include <charconv>
 #include <exception>
+#include <format>
 #include <span>
+#include <stdexcept>
+
+namespace {
+[[nodiscard]] auto parse_present_mode(std::string_view const text)
+	-> vk::PresentModeKHR {
+	if (text == "fifo") { return vk::PresentModeKHR::eFifo; }
+	if (text == "fifo-relaxed") { return vk::PresentModeKHR::eFifoRelaxed; }
+	if (text == "mailbox") { return vk::PresentModeKHR::eMailbox; }
+	if (text == "immediate") { return vk::PresentModeKHR::eImmediate; }
+	throw std::runtime_error{std::format("Invalid present mode: '{}'", text)};
+}
+
+template <typename Type>
+[[nodiscard]] auto parse_number(std::string_view const text) -> Type {
+	auto ret = Type{};
+	auto const* end = text.data() + text.size();
+	auto const [ptr, ec] = std::from_chars(text.data(), end, ret);
+	if (ec != std::errc{} || ptr != end) {
+		throw std::runtime_error{std::format("Invalid number: '{}'", text)};
+	}
+	return ret;
+}
+} // namespace
 
 auto main(int argc, char** argv) -> int {
 	try {
@@ -10,16 +36,58 @@ auto main(int argc, char** argv) -> int {
 		spdlog::set_default_logger(fileLogger);
 		spdlog::info("application started");
 
+		auto create_info = lvk::App::CreateInfo{};
 		// skip the first argument.
 		auto args = std::span{argv, static_cast<std::size_t>(argc)}.subspan(1);
+		// consumes and returns the value following the current argument.
+		auto const next_value = [&args] {
+			if (args.size() < 2) {
+				throw std::runtime_error{
+					std::format("Missing value for '{}'", args.front())};
+			}
+			args = args.subspan(1);
+			return std::string_view{args.front()};
+		};
 		while (!args.empty()) {
 			auto const arg = std::string_view{args.front()};
 			if (arg == "-x" || arg == "--force-x11") {
 				glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
+			} else if (arg == "--headless") {
+				create_info.headless = true;
+			} else if (arg == "--frames") {
+				create_info.frame_count =
+					parse_number<std::uint64_t>(next_value());
+			} else if (arg == "--frames-in-flight") {
+				create_info.frames_in_flight =
+					parse_number<std::size_t>(next_value());
+			} else if (arg == "--present-mode") {
+				create_info.swapchain_policy.present_mode =
+					parse_present_mode(next_value());
+			} else if (arg == "--swapchain-images") {
+				create_info.swapchain_policy.image_count =
+					parse_number<std::uint32_t>(next_value());
+			} else if (arg == "--trace") {
+				create_info.trace_path = next_value();
+			} else if (arg == "--record-threads") {
+				create_info.record_threads =
+					parse_number<std::size_t>(next_value());
+			} else if (arg == "--job-workers") {
+				create_info.job_workers =
+					parse_number<std::size_t>(next_value());
+			} else if (arg == "--memory-stats") {
+				create_info.memory_stats_path = next_value();
+			} else if (arg == "--texture") {
+				create_info.texture_path = next_value();
+			} else if (arg == "--compress-textures") {
+				create_info.compress_textures = true;
+			} else if (arg == "--bench") {
+				// run a CPU benchmark instead of the app.
+				lvk::run_benchmark(next_value());
+				return EXIT_SUCCESS;
 			}
 			args = args.subspan(1);
 		}
-		lvk::App{}.run();
+		lvk::App{create_info}.run();
 	} catch (std::exception const& e) {
 		spdlog::error("PANIC: {}", e.what());
 		return EXIT_FAILURE;
@@ -0,0 +1,85 @@
+#include <mapped_file.hpp>
+#include <spdlog/spdlog.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lvk {
+#if defined(_WIN32)
+auto map_file(fs::path const& path) -> MappedFile {
+	auto const file =
+		CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+					OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		spdlog::error("[lvk] Failed to open file: '{}'", path.generic_string());
+		return {};
+	}
+	auto size = LARGE_INTEGER{};
+	auto const has_size = GetFileSizeEx(file, &size) != 0;
+	auto const mapping =
+		has_size && size.QuadPart > 0
+			? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+			: nullptr;
+	// the mapping keeps the file open.
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		spdlog::error("[lvk] Failed to map file: '{}'", path.generic_string());
+		return {};
+	}
+	auto const* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	// the view keeps the mapping alive.
+	CloseHandle(mapping);
+	if (data == nullptr) {
+		spdlog::error("[lvk] Failed to map file: '{}'", path.generic_string());
+		return {};
+	}
+	return RawMappedFile{
+		.data = static_cast<std::byte const*>(data),
+		.size = static_cast<std::size_t>(size.QuadPart),
+	};
+}
+
+void MappedFileDeleter::operator()(
+	RawMappedFile const& raw_mapped_file) const noexcept {
+	UnmapViewOfFile(raw_mapped_file.data);
+}
+#else
+auto map_file(fs::path const& path) -> MappedFile {
+	auto const fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		spdlog::error("[lvk] Failed to open file: '{}'", path.generic_string());
+		return {};
+	}
+	struct stat file_stat{};
+	auto const has_size = fstat(fd, &file_stat) == 0 && file_stat.st_size > 0;
+	auto* const data =
+		has_size ? mmap(nullptr, static_cast<std::size_t>(file_stat.st_size),
+						PROT_READ, MAP_PRIVATE, fd, 0)
+				 : MAP_FAILED;
+	// the mapping keeps the file open.
+	close(fd);
+	if (data == MAP_FAILED) {
+		spdlog::error("[lvk] Failed to map file: '{}'", path.generic_string());
+		return {};
+	}
+	return RawMappedFile{
+		.data = static_cast<std::byte const*>(data),
+		.size = static_cast<std::size_t>(file_stat.st_size),
+	};
+}
+
+void MappedFileDeleter::operator()(
+	RawMappedFile const& raw_mapped_file) const noexcept {
+	munmap(const_cast<std::byte*>(raw_mapped_file.data),
+		   raw_mapped_file.size);
+}
+#endif
+} // namespace lvk
@@ -0,0 +1,30 @@
+#pragma once
+#include <scoped.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace lvk {
+namespace fs = std::filesystem;
+
+// Read-only view of a memory mapped file.
+struct RawMappedFile {
+	auto operator==(RawMappedFile const& rhs) const -> bool = default;
+
+	[[nodiscard]] auto bytes() const -> std::span<std::byte const> {
+		return {data, size};
+	}
+
+	std::byte const* data{};
+	std::size_t size{};
+};
+
+struct MappedFileDeleter {
+	void operator()(RawMappedFile const& raw_mapped_file) const noexcept;
+};
+
+using MappedFile = Scoped<RawMappedFile, MappedFileDeleter>;
+
+// returns an empty MappedFile on failure (or if the file is empty).
+[[nodiscard]] auto map_file(fs::path const& path) -> MappedFile;
+} // namespace lvk
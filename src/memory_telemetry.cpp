@@ -0,0 +1,141 @@
+#include <imgui.h>
+#include <memory_telemetry.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <fstream>
+#include <ranges>
+
+namespace lvk {
+namespace {
+constexpr auto to_mib(vk::DeviceSize const bytes) -> double {
+	return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+constexpr auto json_path_v = "memory_stats.json";
+} // namespace
+
+MemoryTelemetry::MemoryTelemetry(VmaAllocator allocator)
+	: m_allocator(allocator) {}
+
+MemoryTelemetry::~MemoryTelemetry() {
+	auto total = VmaTotalStatistics{};
+	vmaCalculateStatistics(m_allocator, &total);
+	auto const& counts = vma::get_allocation_counts();
+	auto const live = total.total.statistics.allocationCount;
+	if (live == 0) {
+		spdlog::info("[MemoryTelemetry] No live allocations at exit");
+		return;
+	}
+
+	spdlog::warn("[MemoryTelemetry] {} live allocations at exit ({} bytes)",
+				 live, total.total.statistics.allocationBytes);
+	for (auto const [index, count] : std::views::enumerate(counts)) {
+		if (count.live == 0) { continue; }
+		auto const category = static_cast<vma::AllocationCategory>(index);
+		spdlog::warn("  {}: {} live", vma::to_string(category), count.live);
+	}
+	// the detailed map lists each live allocation with its category name.
+	spdlog::warn("{}", build_json(true));
+}
+
+auto MemoryTelemetry::get_heaps() const -> std::vector<HeapUsage> {
+	VkPhysicalDeviceMemoryProperties const* properties{};
+	vmaGetMemoryProperties(m_allocator, &properties);
+	auto budgets = std::vector<VmaBudget>(properties->memoryHeapCount);
+	vmaGetHeapBudgets(m_allocator, budgets.data());
+
+	auto ret = std::vector<HeapUsage>{};
+	ret.reserve(budgets.size());
+	for (auto const [index, budget] : std::views::enumerate(budgets)) {
+		auto const& heap = properties->memoryHeaps[index];
+		ret.push_back(HeapUsage{
+			.size = heap.size,
+			.budget = budget.budget,
+			.usage = budget.usage,
+			.block_bytes = budget.statistics.blockBytes,
+			.allocation_bytes = budget.statistics.allocationBytes,
+			.allocation_count = budget.statistics.allocationCount,
+			.device_local =
+				(heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+		});
+	}
+	return ret;
+}
+
+auto MemoryTelemetry::build_json(bool const detailed) const -> std::string {
+	char* stats{};
+	vmaBuildStatsString(m_allocator, &stats, detailed ? VK_TRUE : VK_FALSE);
+	auto ret = std::string{stats};
+	vmaFreeStatsString(m_allocator, stats);
+	return ret;
+}
+
+auto MemoryTelemetry::write_json(fs::path const& path,
+								 bool const detailed) const -> bool {
+	auto file = std::ofstream{path};
+	if (!file) {
+		spdlog::error("[MemoryTelemetry] Failed to open '{}'",
+					  path.generic_string());
+		return false;
+	}
+	file << build_json(detailed);
+	spdlog::info("[MemoryTelemetry] Wrote '{}'", path.generic_string());
+	return true;
+}
+
+void MemoryTelemetry::log_summary() const {
+	for (auto const [index, heap] : std::views::enumerate(get_heaps())) {
+		spdlog::info("[MemoryTelemetry] Heap {}{}: {:.1f} / {:.1f} MiB used "
+					 "(size {:.1f} MiB), {} allocations",
+					 index, heap.device_local ? " (device local)" : "",
+					 to_mib(heap.usage), to_mib(heap.budget),
+					 to_mib(heap.size), heap.allocation_count);
+	}
+	auto const& counts = vma::get_allocation_counts();
+	for (auto const [index, count] : std::views::enumerate(counts)) {
+		auto const category = static_cast<vma::AllocationCategory>(index);
+		spdlog::info("[MemoryTelemetry] {}: {} created, {} live",
+					 vma::to_string(category), count.created, count.live);
+	}
+}
+
+void MemoryTelemetry::inspect() {
+	auto const heaps = get_heaps();
+	m_peak_usage.resize(heaps.size());
+
+	ImGui::SetNextWindowSize({320.0f, 240.0f}, ImGuiCond_Once);
+	if (ImGui::Begin("Memory")) {
+		for (auto const [index, heap] : std::views::enumerate(heaps)) {
+			auto& peak = m_peak_usage.at(static_cast<std::size_t>(index));
+			peak = std::max(peak, heap.usage);
+			ImGui::Text("heap %d%s: %.1f / %.1f MiB (peak %.1f)",
+						static_cast<int>(index),
+						heap.device_local ? " (device local)" : "",
+						to_mib(heap.usage), to_mib(heap.budget),
+						to_mib(peak));
+			auto const ratio = heap.budget == 0
+								   ? 0.0f
+								   : static_cast<float>(heap.usage) /
+										 static_cast<float>(heap.budget);
+			ImGui::ProgressBar(ratio, {-1.0f, 0.0f});
+			ImGui::Text("  %u allocations, %.1f MiB in %.1f MiB of blocks",
+						heap.allocation_count, to_mib(heap.allocation_bytes),
+						to_mib(heap.block_bytes));
+		}
+
+		ImGui::Separator();
+		auto const& counts = vma::get_allocation_counts();
+		for (auto const [index, count] : std::views::enumerate(counts)) {
+			auto const category = static_cast<vma::AllocationCategory>(index);
+			auto const name = vma::to_string(category);
+			ImGui::Text("%.*s: %llu live (%llu created)",
+						static_cast<int>(name.size()), name.data(),
+						static_cast<unsigned long long>(count.live),
+						static_cast<unsigned long long>(count.created));
+		}
+
+		if (ImGui::Button("dump JSON")) { write_json(json_path_v, true); }
+	}
+	ImGui::End();
+}
+} // namespace lvk
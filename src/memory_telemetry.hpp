@@ -0,0 +1,56 @@
+#pragma once
+#include <vma.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace lvk {
+namespace fs = std::filesystem;
+
+struct HeapUsage {
+	vk::DeviceSize size{};
+	// estimated bytes available to this process.
+	vk::DeviceSize budget{};
+	// estimated bytes used by this process (VMA and otherwise).
+	vk::DeviceSize usage{};
+	// bytes in VMA memory blocks, and in allocations within them.
+	vk::DeviceSize block_bytes{};
+	vk::DeviceSize allocation_bytes{};
+	std::uint32_t allocation_count{};
+	bool device_local{};
+};
+
+// Reports device memory budgets, usage and allocation counts of a VMA
+// allocator. Budgets are driver estimates if VK_EXT_memory_budget is
+// enabled, else derived from heap sizes.
+// Logs allocations still alive on destruction (leaks): should be destroyed
+// after all resources and before the allocator.
+class MemoryTelemetry {
+  public:
+	explicit MemoryTelemetry(VmaAllocator allocator);
+	~MemoryTelemetry();
+
+	MemoryTelemetry(MemoryTelemetry const&) = delete;
+	MemoryTelemetry(MemoryTelemetry&&) = delete;
+	auto operator=(MemoryTelemetry const&) = delete;
+	auto operator=(MemoryTelemetry&&) = delete;
+
+	[[nodiscard]] auto get_heaps() const -> std::vector<HeapUsage>;
+
+	// VMA statistics as JSON, detailed includes every allocation.
+	[[nodiscard]] auto build_json(bool detailed) const -> std::string;
+	// returns false if path could not be written to.
+	auto write_json(fs::path const& path, bool detailed) const -> bool;
+
+	// logs usage and budget of each heap, and allocation counts.
+	void log_summary() const;
+
+	// draws the ImGui panel.
+	void inspect();
+
+  private:
+	VmaAllocator m_allocator{};
+	// highest usage seen by inspect(), per heap.
+	std::vector<vk::DeviceSize> m_peak_usage{};
+};
+} // namespace lvk
@@ -0,0 +1,209 @@
+#include <mip_chain.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LVK_SSE2
+#endif
+
+namespace lvk {
+namespace {
+constexpr std::size_t channels_v{4};
+
+// 2x2 box filter of src (src_width x src_height) into dst, edges clamped
+// for odd sizes.
+void downsample(std::byte const* src, std::uint32_t const src_width,
+				std::uint32_t const src_height, std::byte* dst,
+				vk::Extent2D const dst_extent) {
+	auto const src_stride = std::size_t{src_width} * channels_v;
+	for (auto y = 0u; y < dst_extent.height; ++y) {
+		auto const* row0 = reinterpret_cast<std::uint8_t const*>(
+			src + std::size_t{std::min(2 * y, src_height - 1)} * src_stride);
+		auto const* row1 = reinterpret_cast<std::uint8_t const*>(
+			src +
+			std::size_t{std::min(2 * y + 1, src_height - 1)} * src_stride);
+		auto* out = reinterpret_cast<std::uint8_t*>(
+			dst + std::size_t{y} * dst_extent.width * channels_v);
+
+		auto x = 0u;
+#if defined(LVK_SSE2)
+		// 4 output pixels (8 input pixels per row) at a time, while all input
+		// pixels are within the row.
+		auto const zero = _mm_setzero_si128();
+		auto const round = _mm_set1_epi16(2);
+		// sums of horizontally adjacent pixels in 8 vertically summed u16s.
+		auto const pair_sums = [](__m128i const lo, __m128i const hi) {
+			auto const sum_lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+			auto const sum_hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+			return _mm_unpacklo_epi64(sum_lo, sum_hi);
+		};
+		auto const average = [&](std::uint8_t const* in0,
+								 std::uint8_t const* in1) {
+			auto const a =
+				_mm_loadu_si128(reinterpret_cast<__m128i const*>(in0));
+			auto const b =
+				_mm_loadu_si128(reinterpret_cast<__m128i const*>(in1));
+			auto const lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+										  _mm_unpacklo_epi8(b, zero));
+			auto const hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+										  _mm_unpackhi_epi8(b, zero));
+			auto const sum = _mm_add_epi16(pair_sums(lo, hi), round);
+			return _mm_srli_epi16(sum, 2);
+		};
+		for (; 2 * (x + 4) <= src_width && x + 4 <= dst_extent.width;
+			 x += 4) {
+			auto const offset = std::size_t{2 * x} * channels_v;
+			auto const first = average(row0 + offset, row1 + offset);
+			auto const second = average(row0 + offset + 16, row1 + offset + 16);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * channels_v),
+							 _mm_packus_epi16(first, second));
+		}
+#endif
+		for (; x < dst_extent.width; ++x) {
+			auto const x0 = std::size_t{std::min(2 * x, src_width - 1)};
+			auto const x1 = std::size_t{std::min(2 * x + 1, src_width - 1)};
+			for (auto c = 0uz; c < channels_v; ++c) {
+				auto const sum = row0[x0 * channels_v + c] +
+								 row0[x1 * channels_v + c] +
+								 row1[x0 * channels_v + c] +
+								 row1[x1 * channels_v + c] + 2;
+				out[x * channels_v + c] = static_cast<std::uint8_t>(sum / 4);
+			}
+		}
+	}
+}
+} // namespace
+
+auto get_mip_levels(vk::Extent2D const extent, MipSettings const& settings)
+	-> std::uint32_t {
+	if (!settings.generate) { return 1; }
+	auto const max_dimension = std::max({extent.width, extent.height, 1u});
+	// floor(log2(max_dimension)) + 1.
+	auto const ret = static_cast<std::uint32_t>(std::bit_width(max_dimension));
+	if (settings.max_levels == 0) { return ret; }
+	return std::min(ret, settings.max_levels);
+}
+
+auto supports_linear_blit(vk::PhysicalDevice const physical_device,
+						  vk::Format const format) -> bool {
+	static constexpr auto features_v =
+		vk::FormatFeatureFlagBits::eBlitSrc |
+		vk::FormatFeatureFlagBits::eBlitDst |
+		vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+	auto const properties = physical_device.getFormatProperties(format);
+	return (properties.optimalTilingFeatures & features_v) == features_v;
+}
+
+void record_mip_blits(vk::CommandBuffer const command_buffer,
+					  vk::Image const image, vk::Extent2D const extent,
+					  std::uint32_t const levels,
+					  vk::ImageLayout const layout) {
+	auto subresource_range = vk::ImageSubresourceRange{};
+	subresource_range.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(1)
+		.setLevelCount(1);
+	auto barrier = vk::ImageMemoryBarrier2{};
+	barrier.setImage(image).setSubresourceRange(subresource_range);
+	auto dependency_info = vk::DependencyInfo{};
+
+	// base level: layout => TransferSrc.
+	// other levels: (discarded) => TransferDst.
+	auto barriers = std::array<vk::ImageMemoryBarrier2, 2>{barrier, barrier};
+	barriers[0]
+		.setOldLayout(layout)
+		.setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+		.setSrcStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+		.setSrcAccessMask(vk::AccessFlagBits2::eMemoryWrite)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eBlit)
+		.setDstAccessMask(vk::AccessFlagBits2::eTransferRead);
+	barriers[1]
+		.setOldLayout(vk::ImageLayout::eUndefined)
+		.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+		.setSrcStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+		.setSrcAccessMask(vk::AccessFlagBits2::eNone)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eBlit)
+		.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+	barriers[1].subresourceRange.setBaseMipLevel(1).setLevelCount(levels - 1);
+	dependency_info.setImageMemoryBarriers(barriers);
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	auto src_layers = vk::ImageSubresourceLayers{};
+	src_layers.setAspectMask(vk::ImageAspectFlagBits::eColor).setLayerCount(1);
+	auto dst_layers = src_layers;
+	for (auto level = 1u; level < levels; ++level) {
+		auto const src_extent = get_mip_extent(extent, level - 1);
+		auto const dst_extent = get_mip_extent(extent, level);
+		src_layers.setMipLevel(level - 1);
+		dst_layers.setMipLevel(level);
+		auto image_blit = vk::ImageBlit2{};
+		image_blit.setSrcSubresource(src_layers)
+			.setDstSubresource(dst_layers)
+			.setSrcOffsets({vk::Offset3D{},
+							vk::Offset3D{static_cast<int>(src_extent.width),
+										 static_cast<int>(src_extent.height),
+										 1}})
+			.setDstOffsets({vk::Offset3D{},
+							vk::Offset3D{static_cast<int>(dst_extent.width),
+										 static_cast<int>(dst_extent.height),
+										 1}});
+		auto blit_info = vk::BlitImageInfo2{};
+		blit_info.setSrcImage(image)
+			.setSrcImageLayout(vk::ImageLayout::eTransferSrcOptimal)
+			.setDstImage(image)
+			.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setRegions(image_blit)
+			.setFilter(vk::Filter::eLinear);
+		command_buffer.blitImage2(blit_info);
+
+		// the level is the source of the next blit.
+		barrier.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+			.setSrcStageMask(vk::PipelineStageFlagBits2::eBlit)
+			.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eBlit)
+			.setDstAccessMask(vk::AccessFlagBits2::eTransferRead);
+		barrier.subresourceRange.setBaseMipLevel(level).setLevelCount(1);
+		dependency_info.setImageMemoryBarriers(barrier);
+		command_buffer.pipelineBarrier2(dependency_info);
+	}
+
+	// all levels: TransferSrc => ShaderReadOnly.
+	barrier.setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
+		.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+		.setSrcStageMask(vk::PipelineStageFlagBits2::eBlit)
+		.setSrcAccessMask(vk::AccessFlagBits2::eNone)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eAllGraphics)
+		.setDstAccessMask(vk::AccessFlagBits2::eShaderSampledRead);
+	barrier.subresourceRange.setBaseMipLevel(0).setLevelCount(levels);
+	dependency_info.setImageMemoryBarriers(barrier);
+	command_buffer.pipelineBarrier2(dependency_info);
+}
+
+auto build_mip_chain(Bitmap const& bitmap, std::uint32_t const levels)
+	-> MipChain {
+	auto const base = vk::Extent2D{static_cast<std::uint32_t>(bitmap.size.x),
+								   static_cast<std::uint32_t>(bitmap.size.y)};
+	auto ret = MipChain{};
+	auto size = 0uz;
+	for (auto level = 1u; level < levels; ++level) {
+		auto const extent = get_mip_extent(base, level);
+		ret.offsets.push_back(size);
+		size += std::size_t{extent.width} * extent.height * channels_v;
+	}
+	ret.bytes.resize(size);
+
+	auto const* src = bitmap.bytes.data();
+	auto src_extent = base;
+	for (auto level = 1u; level < levels; ++level) {
+		auto* dst = ret.bytes.data() + ret.offsets.at(level - 1);
+		auto const dst_extent = get_mip_extent(base, level);
+		downsample(src, src_extent.width, src_extent.height, dst, dst_extent);
+		src = dst;
+		src_extent = dst_extent;
+	}
+	return ret;
+}
+} // namespace lvk
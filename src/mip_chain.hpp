@@ -0,0 +1,52 @@
+#pragma once
+#include <bitmap.hpp>
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace lvk {
+struct MipSettings {
+	// generate mip levels below the base level at upload time.
+	bool generate{true};
+	// maximum number of levels (including the base), 0 for a full chain.
+	std::uint32_t max_levels{};
+};
+
+// number of levels of an image of extent with settings applied.
+[[nodiscard]] auto get_mip_levels(vk::Extent2D extent,
+								  MipSettings const& settings)
+	-> std::uint32_t;
+
+[[nodiscard]] constexpr auto get_mip_extent(vk::Extent2D const extent,
+											std::uint32_t const level) {
+	return vk::Extent2D{
+		std::max(extent.width >> level, 1u),
+		std::max(extent.height >> level, 1u),
+	};
+}
+
+// format can be blitted from / to with linear filtering (optimal tiling).
+[[nodiscard]] auto supports_linear_blit(vk::PhysicalDevice physical_device,
+										vk::Format format) -> bool;
+
+// records a chain of blits generating levels [1, levels) of image from its
+// base level, leaving all levels in ShaderReadOnlyOptimal.
+// all levels must be in layout, and writes to the base level must have
+// been made available (by a prior copy or barrier).
+// requires a graphics queue, and linear blit support for the format.
+void record_mip_blits(vk::CommandBuffer command_buffer, vk::Image image,
+					  vk::Extent2D extent, std::uint32_t levels,
+					  vk::ImageLayout layout);
+
+// levels below the base level of an RGBA8 Bitmap, tightly packed.
+struct MipChain {
+	std::vector<std::byte> bytes{};
+	// byte offset of each level in bytes, starting at level 1.
+	std::vector<std::size_t> offsets{};
+};
+
+// CPU fallback of record_mip_blits() for RGBA8 Bitmaps: each level is a 2x2
+// box filter of the previous one (SSE2 when available).
+[[nodiscard]] auto build_mip_chain(Bitmap const& bitmap, std::uint32_t levels)
+	-> MipChain;
+} // namespace lvk
@@ -0,0 +1,78 @@
+#include <offscreen_ring.hpp>
+#include <cassert>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+constexpr auto subresource_range_v = [] {
+	auto ret = vk::ImageSubresourceRange{};
+	ret.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(1)
+		.setLevelCount(1);
+	return ret;
+}();
+} // namespace
+
+OffscreenRing::OffscreenRing(vk::Device const device,
+							 VmaAllocator const allocator,
+							 std::uint32_t const queue_family,
+							 glm::ivec2 const size, std::size_t const count)
+	: m_queue_family(queue_family) {
+	if (size.x <= 0 || size.y <= 0 || count == 0) {
+		throw std::runtime_error{"Invalid offscreen image ring"};
+	}
+	auto const usize = glm::uvec2{size};
+	m_extent = vk::Extent2D{usize.x, usize.y};
+
+	auto const image_ci = vma::ImageCreateInfo{
+		.allocator = allocator,
+		.queue_family = queue_family,
+	};
+	// images are rendered to, and can be copied out of for readback.
+	static constexpr auto usage_v = vk::ImageUsageFlagBits::eColorAttachment |
+									vk::ImageUsageFlagBits::eTransferSrc;
+	auto image_view_ci = vk::ImageViewCreateInfo{};
+	image_view_ci.setViewType(vk::ImageViewType::e2D)
+		.setFormat(format_v)
+		.setSubresourceRange(subresource_range_v);
+
+	m_slots.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		auto slot = Slot{};
+		slot.image =
+			vma::create_image(image_ci, usage_v, 1, format_v, m_extent);
+		if (!slot.image.get().image) {
+			throw std::runtime_error{"Failed to create offscreen image"};
+		}
+		image_view_ci.setImage(slot.image.get().image);
+		slot.image_view = device.createImageViewUnique(image_view_ci);
+		m_slots.push_back(std::move(slot));
+	}
+}
+
+auto OffscreenRing::acquire_next_image() -> RenderTarget {
+	assert(!m_image_index);
+	m_image_index = m_next_index;
+	auto const& slot = m_slots.at(*m_image_index);
+	return RenderTarget{
+		.image = slot.image.get().image,
+		.image_view = *slot.image_view,
+		.extent = m_extent,
+	};
+}
+
+auto OffscreenRing::base_barrier() const -> vk::ImageMemoryBarrier2 {
+	auto ret = vk::ImageMemoryBarrier2{};
+	ret.setImage(m_slots.at(m_image_index.value()).image.get().image)
+		.setSubresourceRange(subresource_range_v)
+		.setSrcQueueFamilyIndex(m_queue_family)
+		.setDstQueueFamilyIndex(m_queue_family);
+	return ret;
+}
+
+void OffscreenRing::present() {
+	assert(m_image_index);
+	m_next_index = (*m_image_index + 1) % m_slots.size();
+	m_image_index.reset();
+}
+} // namespace lvk
@@ -0,0 +1,44 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <render_target.hpp>
+#include <vma.hpp>
+#include <optional>
+#include <vector>
+
+namespace lvk {
+// Ring of VMA allocated color images, used in place of a Swapchain when
+// rendering headless.
+class OffscreenRing {
+  public:
+	static constexpr auto format_v = vk::Format::eR8G8B8A8Srgb;
+
+	explicit OffscreenRing(vk::Device device, VmaAllocator allocator,
+						   std::uint32_t queue_family, glm::ivec2 size,
+						   std::size_t count);
+
+	[[nodiscard]] auto get_size() const -> glm::ivec2 {
+		return {m_extent.width, m_extent.height};
+	}
+
+	[[nodiscard]] auto get_format() const -> vk::Format { return format_v; }
+
+	[[nodiscard]] auto acquire_next_image() -> RenderTarget;
+
+	[[nodiscard]] auto base_barrier() const -> vk::ImageMemoryBarrier2;
+
+	// advances to the next image in the ring.
+	void present();
+
+  private:
+	struct Slot {
+		vma::Image image{};
+		vk::UniqueImageView image_view{};
+	};
+
+	std::uint32_t m_queue_family{};
+	vk::Extent2D m_extent{};
+	std::vector<Slot> m_slots{};
+	std::size_t m_next_index{};
+	std::optional<std::size_t> m_image_index{};
+};
+} // namespace lvk
@@ -0,0 +1,98 @@
+#include <parallel_recorder.hpp>
+#include <algorithm>
+#include <exception>
+
+namespace lvk {
+ParallelRecorder::ParallelRecorder(vk::Device const device,
+								   std::uint32_t const queue_family,
+								   std::size_t const buffering,
+								   std::size_t const workers,
+								   JobSystem& jobs)
+	: m_device(device), m_jobs(&jobs), m_workers(std::max(workers, 1uz)) {
+	auto command_pool_ci = vk::CommandPoolCreateInfo{};
+	// Command Buffers are re-recorded every frame, after resetting the pool.
+	command_pool_ci.setFlags(vk::CommandPoolCreateFlagBits::eTransient)
+		.setQueueFamilyIndex(queue_family);
+	auto command_buffer_ai = vk::CommandBufferAllocateInfo{};
+	command_buffer_ai.setCommandBufferCount(1).setLevel(
+		vk::CommandBufferLevel::eSecondary);
+
+	// Command Pools are externally synchronized: each partition gets its own,
+	// and is recorded by exactly one job.
+	for (auto& worker : m_workers) {
+		worker.command_pools.resize(buffering);
+		worker.command_buffers.resize(buffering);
+		for (std::size_t i = 0; i < buffering; ++i) {
+			auto& pool = worker.command_pools.at(i);
+			pool = m_device.createCommandPoolUnique(command_pool_ci);
+			command_buffer_ai.setCommandPool(*pool);
+			worker.command_buffers.at(i) =
+				m_device.allocateCommandBuffers(command_buffer_ai).front();
+		}
+	}
+	m_recorded.reserve(m_workers.size());
+}
+
+auto ParallelRecorder::record(std::size_t const frame_index,
+							  vk::Format const color_format,
+							  std::uint32_t const draw_count,
+							  RecordFunc const& func)
+	-> std::span<vk::CommandBuffer const> {
+	m_recorded.clear();
+	if (draw_count == 0) { return {}; }
+
+	// secondary Command Buffers inherit the dynamic rendering pass of the
+	// primary that executes them.
+	auto rendering_info = vk::CommandBufferInheritanceRenderingInfo{};
+	rendering_info.setColorAttachmentFormats(color_format)
+		.setRasterizationSamples(vk::SampleCountFlagBits::e1);
+	auto inheritance_info = vk::CommandBufferInheritanceInfo{};
+	inheritance_info.setPNext(&rendering_info);
+	auto begin_info = vk::CommandBufferBeginInfo{};
+	begin_info
+		.setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue |
+				  vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+		.setPInheritanceInfo(&inheritance_info);
+
+	auto const worker_count =
+		std::min(m_workers.size(), static_cast<std::size_t>(draw_count));
+	// the first (draw_count % worker_count) partitions get one extra draw:
+	// every partition is within the draw list and none are empty, as
+	// worker_count <= draw_count.
+	auto const base_size =
+		static_cast<std::uint32_t>(draw_count / worker_count);
+	auto const remainder =
+		static_cast<std::uint32_t>(draw_count % worker_count);
+
+	auto const record_partition = [&](std::size_t const index) {
+		auto const& worker = m_workers.at(index);
+		auto const uindex = static_cast<std::uint32_t>(index);
+		auto const first = uindex * base_size + std::min(uindex, remainder);
+		auto const count = base_size + (uindex < remainder ? 1u : 0u);
+		m_device.resetCommandPool(*worker.command_pools.at(frame_index));
+		auto const command_buffer = worker.command_buffers.at(frame_index);
+		command_buffer.begin(begin_info);
+		func(command_buffer, first, count);
+		command_buffer.end();
+	};
+
+	auto recorded = JobCounter{};
+	for (std::size_t i = 1; i < worker_count; ++i) {
+		m_jobs->submit([&record_partition, i] { record_partition(i); },
+					   &recorded);
+	}
+	// recorded must outlive the jobs even if this throws.
+	auto exception = std::exception_ptr{};
+	try {
+		record_partition(0);
+	} catch (...) { exception = std::current_exception(); }
+	// rethrows any exceptions thrown by jobs.
+	m_jobs->wait(recorded);
+	if (exception) { std::rethrow_exception(exception); }
+
+	for (std::size_t i = 0; i < worker_count; ++i) {
+		m_recorded.push_back(m_workers.at(i).command_buffers.at(frame_index));
+	}
+	return m_recorded;
+}
+} // namespace lvk
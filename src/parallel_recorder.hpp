@@ -0,0 +1,49 @@
+#pragma once
+#include <job_system.hpp>
+#include <resource_buffering.hpp>
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace lvk {
+// Records a draw list into secondary Command Buffers as jobs, to be
+// executed inside a dynamic rendering pass of the primary.
+class ParallelRecorder {
+  public:
+	// records draws [first, first + count) of the draw list.
+	using RecordFunc = std::function<void(
+		vk::CommandBuffer command_buffer, std::uint32_t first,
+		std::uint32_t count)>;
+
+	// workers is the number of partitions (and Command Pools) per frame.
+	explicit ParallelRecorder(vk::Device device, std::uint32_t queue_family,
+							  std::size_t buffering, std::size_t workers,
+							  JobSystem& jobs);
+
+	// partitions the draw list across workers, returns their recorded
+	// secondary Command Buffers in draw list order. the calling thread
+	// records the first partition and helps with the rest.
+	[[nodiscard]] auto record(std::size_t frame_index, vk::Format color_format,
+							  std::uint32_t draw_count,
+							  RecordFunc const& func)
+		-> std::span<vk::CommandBuffer const>;
+
+	[[nodiscard]] auto get_worker_count() const -> std::size_t {
+		return m_workers.size();
+	}
+
+  private:
+	struct Worker {
+		// one pool per virtual frame, reset as a whole before recording.
+		Buffered<vk::UniqueCommandPool> command_pools{};
+		Buffered<vk::CommandBuffer> command_buffers{};
+	};
+
+	vk::Device m_device{};
+	JobSystem* m_jobs{};
+	std::vector<Worker> m_workers{};
+	std::vector<vk::CommandBuffer> m_recorded{};
+};
+} // namespace lvk
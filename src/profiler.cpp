@@ -0,0 +1,202 @@
+#include <imgui.h>
+#include <profiler.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <format>
+
+namespace lvk {
+namespace {
+// timestamps are written after all prior commands have completed.
+constexpr auto timestamp_stage_v = vk::PipelineStageFlagBits2::eAllCommands;
+
+constexpr std::uint32_t queries_per_frame_v{2 * Profiler::max_gpu_zones_v};
+
+[[nodiscard]] auto to_us(Profiler::Clock::duration const duration) -> double {
+	return std::chrono::duration<double, std::micro>{duration}.count();
+}
+} // namespace
+
+Profiler::CpuZone::CpuZone(Profiler& profiler, std::string_view const name)
+	: m_profiler(&profiler), m_name(name), m_start(Clock::now()) {}
+
+Profiler::CpuZone::~CpuZone() {
+	m_profiler->record_cpu(m_name, m_start, Clock::now());
+}
+
+Profiler::GpuZone::GpuZone(vk::CommandBuffer const command_buffer,
+						   vk::QueryPool const query_pool,
+						   std::uint32_t const query)
+	: m_command_buffer(command_buffer), m_query_pool(query_pool),
+	  m_query(query) {
+	if (!m_query_pool) { return; }
+	m_command_buffer.writeTimestamp2(timestamp_stage_v, m_query_pool, m_query);
+}
+
+Profiler::GpuZone::~GpuZone() {
+	if (!m_query_pool) { return; }
+	m_command_buffer.writeTimestamp2(timestamp_stage_v, m_query_pool,
+									 m_query + 1);
+}
+
+Profiler::Profiler(vk::Device const device, Gpu const& gpu,
+				   std::size_t const buffering, fs::path const& trace_path)
+	: m_device(device), m_frames(buffering) {
+	auto const queue_families = gpu.device.getQueueFamilyProperties();
+	auto const valid_bits =
+		queue_families.at(gpu.queue_family).timestampValidBits;
+	if (valid_bits > 0) {
+		m_timestamp_period =
+			static_cast<double>(gpu.properties.limits.timestampPeriod);
+		m_timestamp_mask = valid_bits >= 64
+							   ? ~std::uint64_t{}
+							   : (std::uint64_t{1} << valid_bits) - 1;
+		auto query_pool_ci = vk::QueryPoolCreateInfo{};
+		query_pool_ci.setQueryType(vk::QueryType::eTimestamp)
+			.setQueryCount(queries_per_frame_v);
+		for (auto& frame : m_frames) {
+			frame.query_pool = m_device.createQueryPoolUnique(query_pool_ci);
+		}
+		m_timestamps.resize(queries_per_frame_v);
+	} else {
+		spdlog::warn("[lvk] Queue does not support timestamps, GPU zones "
+					 "disabled");
+	}
+
+	if (trace_path.empty()) { return; }
+	m_trace.open(trace_path);
+	if (!m_trace.is_open()) {
+		spdlog::error("[lvk] Failed to open trace file: '{}'",
+					  trace_path.generic_string());
+		return;
+	}
+	m_trace << R"({"traceEvents":[)" << '\n';
+	m_trace << R"({"name":"process_name","ph":"M","pid":0,)"
+			<< R"("args":{"name":"CPU"}},)" << '\n';
+	m_trace << R"({"name":"process_name","ph":"M","pid":1,)"
+			<< R"("args":{"name":"GPU"}})";
+	m_first_event = false;
+}
+
+Profiler::~Profiler() {
+	if (!m_trace.is_open()) { return; }
+	// results of frames still in flight are dropped.
+	m_trace << "\n]}\n";
+}
+
+void Profiler::begin_frame(vk::CommandBuffer const command_buffer,
+						   std::size_t const frame_index) {
+	m_frame_index = frame_index;
+	auto& frame = m_frames.at(m_frame_index);
+	if (!frame.query_pool) { return; }
+
+	collect(frame);
+	command_buffer.resetQueryPool(*frame.query_pool, 0, queries_per_frame_v);
+	frame.anchor = Clock::now();
+}
+
+auto Profiler::cpu_zone(std::string_view const name) -> CpuZone {
+	return CpuZone{*this, name};
+}
+
+auto Profiler::gpu_zone(vk::CommandBuffer const command_buffer,
+						std::string_view const name) -> GpuZone {
+	auto& frame = m_frames.at(m_frame_index);
+	if (!frame.query_pool || frame.records.size() >= max_gpu_zones_v) {
+		return GpuZone{command_buffer, {}, {}};
+	}
+	auto const query = static_cast<std::uint32_t>(2 * frame.records.size());
+	frame.records.push_back(GpuRecord{.name = name, .query = query});
+	return GpuZone{command_buffer, *frame.query_pool, query};
+}
+
+void Profiler::record_cpu(std::string_view const name,
+						  Clock::time_point const start,
+						  Clock::time_point const end) {
+	record("cpu", name, start, end - start);
+}
+
+void Profiler::inspect() {
+	ImGui::SetNextWindowSize({320.0f, 400.0f}, ImGuiCond_Once);
+	if (ImGui::Begin("Profiler")) {
+		auto lock = std::scoped_lock{m_mutex};
+		for (auto const& stats : m_stats) {
+			auto const& history = stats.history;
+			auto const latest =
+				history.at((stats.head + history.size() - 1) % history.size());
+			auto const max = *std::ranges::max_element(history);
+			ImGui::Text("%s: %.3f ms (max %.3f)", stats.label.c_str(),
+						static_cast<double>(latest), static_cast<double>(max));
+			ImGui::PushID(stats.label.c_str());
+			ImGui::PlotLines("##history", history.data(),
+							 static_cast<int>(history.size()),
+							 static_cast<int>(stats.head), nullptr, 0.0f, max,
+							 {-1.0f, 40.0f});
+			ImGui::PopID();
+		}
+	}
+	ImGui::End();
+}
+
+void Profiler::collect(Frame& frame) {
+	if (frame.records.empty()) { return; }
+
+	// the frame's submission has completed, results are either available or
+	// were never written: never wait here.
+	auto const query_count =
+		static_cast<std::uint32_t>(2 * frame.records.size());
+	auto const result = m_device.getQueryPoolResults(
+		*frame.query_pool, 0, query_count, query_count * sizeof(std::uint64_t),
+		m_timestamps.data(), sizeof(std::uint64_t),
+		vk::QueryResultFlagBits::e64);
+	if (result == vk::Result::eSuccess) {
+		auto const to_duration = [this](std::uint64_t const ticks) {
+			auto const masked = ticks & m_timestamp_mask;
+			auto const ns = static_cast<double>(masked) * m_timestamp_period;
+			return std::chrono::duration_cast<Clock::duration>(
+				std::chrono::duration<double, std::nano>{ns});
+		};
+		auto const origin = m_timestamps.front();
+		for (auto const& gpu_record : frame.records) {
+			auto const begin = m_timestamps.at(gpu_record.query);
+			auto const end = m_timestamps.at(gpu_record.query + 1);
+			auto const start = frame.anchor + to_duration(begin - origin);
+			record("gpu", gpu_record.name, start, to_duration(end - begin));
+		}
+	}
+	frame.records.clear();
+}
+
+void Profiler::record(std::string_view const category,
+					  std::string_view const name,
+					  Clock::time_point const start,
+					  Clock::duration const duration) {
+	auto lock = std::scoped_lock{m_mutex};
+	auto& stats = get_stats(category, name);
+	stats.history.at(stats.head) =
+		std::chrono::duration<float, std::milli>{duration}.count();
+	stats.head = (stats.head + 1) % stats.history.size();
+	write_event(category, name, start, duration);
+}
+
+void Profiler::write_event(std::string_view const category,
+						   std::string_view const name,
+						   Clock::time_point const start,
+						   Clock::duration const duration) {
+	if (!m_trace.is_open()) { return; }
+	if (!m_first_event) { m_trace << ",\n"; }
+	m_first_event = false;
+	auto const pid = category == "gpu" ? 1 : 0;
+	m_trace << std::format(
+		R"({{"name":"{}","cat":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},)"
+		R"("pid":{},"tid":0}})",
+		name, category, to_us(start - m_epoch), to_us(duration), pid);
+}
+
+auto Profiler::get_stats(std::string_view const category,
+						 std::string_view const name) -> Stats& {
+	auto label = std::format("[{}] {}", category, name);
+	auto const it = std::ranges::find(m_stats, label, &Stats::label);
+	if (it != m_stats.end()) { return *it; }
+	return m_stats.emplace_back(Stats{.label = std::move(label)});
+}
+} // namespace lvk
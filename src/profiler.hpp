@@ -0,0 +1,139 @@
+#pragma once
+#include <gpu.hpp>
+#include <resource_buffering.hpp>
+#include <vulkan/vulkan.hpp>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lvk {
+namespace fs = std::filesystem;
+
+// Collects CPU zones and GPU timestamp zones, streams them as Chrome trace
+// JSON (chrome://tracing, Perfetto), and keeps a rolling history per zone.
+class Profiler {
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	// maximum number of GPU zones per virtual frame.
+	static constexpr std::uint32_t max_gpu_zones_v{32};
+	// number of samples in the rolling history of each zone.
+	static constexpr std::size_t history_size_v{120};
+
+	// records the CPU time between construction and destruction.
+	class CpuZone {
+	  public:
+		CpuZone(CpuZone const&) = delete;
+		CpuZone(CpuZone&&) = delete;
+		auto operator=(CpuZone const&) = delete;
+		auto operator=(CpuZone&&) = delete;
+
+		~CpuZone();
+
+	  private:
+		explicit CpuZone(Profiler& profiler, std::string_view name);
+
+		Profiler* m_profiler{};
+		std::string_view m_name{};
+		Clock::time_point m_start{};
+
+		friend class Profiler;
+	};
+
+	// writes GPU timestamps before and after the commands recorded in its
+	// lifetime.
+	class GpuZone {
+	  public:
+		GpuZone(GpuZone const&) = delete;
+		GpuZone(GpuZone&&) = delete;
+		auto operator=(GpuZone const&) = delete;
+		auto operator=(GpuZone&&) = delete;
+
+		~GpuZone();
+
+	  private:
+		explicit GpuZone(vk::CommandBuffer command_buffer,
+						 vk::QueryPool query_pool, std::uint32_t query);
+
+		vk::CommandBuffer m_command_buffer{};
+		vk::QueryPool m_query_pool{};
+		std::uint32_t m_query{};
+
+		friend class Profiler;
+	};
+
+	// trace_path may be empty, to disable Chrome trace output.
+	explicit Profiler(vk::Device device, Gpu const& gpu, std::size_t buffering,
+					  fs::path const& trace_path);
+
+	Profiler(Profiler const&) = delete;
+	Profiler(Profiler&&) = delete;
+	auto operator=(Profiler const&) = delete;
+	auto operator=(Profiler&&) = delete;
+
+	~Profiler();
+
+	// reads back the results of the frame's previous submission and resets
+	// its queries. must be called after waiting for that submission to
+	// complete, and before any GPU zones are recorded.
+	void begin_frame(vk::CommandBuffer command_buffer, std::size_t frame_index);
+
+	[[nodiscard]] auto cpu_zone(std::string_view name) -> CpuZone;
+	[[nodiscard]] auto gpu_zone(vk::CommandBuffer command_buffer,
+								std::string_view name) -> GpuZone;
+
+	// thread-safe.
+	void record_cpu(std::string_view name, Clock::time_point start,
+					Clock::time_point end);
+
+	// draws the rolling ImGui panel.
+	void inspect();
+
+  private:
+	struct GpuRecord {
+		std::string_view name{};
+		std::uint32_t query{}; // begin query, end query is query + 1.
+	};
+
+	struct Frame {
+		vk::UniqueQueryPool query_pool{};
+		std::vector<GpuRecord> records{};
+		// CPU time that the first GPU timestamp is mapped to.
+		Clock::time_point anchor{};
+	};
+
+	struct Stats {
+		std::string label{};
+		std::array<float, history_size_v> history{}; // milliseconds.
+		std::size_t head{};
+	};
+
+	void collect(Frame& frame);
+	void record(std::string_view category, std::string_view name,
+				Clock::time_point start, Clock::duration duration);
+	void write_event(std::string_view category, std::string_view name,
+					 Clock::time_point start, Clock::duration duration);
+	[[nodiscard]] auto get_stats(std::string_view category,
+								 std::string_view name) -> Stats&;
+
+	vk::Device m_device{};
+	// nanoseconds per timestamp tick.
+	double m_timestamp_period{};
+	std::uint64_t m_timestamp_mask{};
+	Clock::time_point m_epoch{Clock::now()};
+
+	Buffered<Frame> m_frames{};
+	std::size_t m_frame_index{};
+	std::vector<std::uint64_t> m_timestamps{};
+
+	std::mutex m_mutex{};
+	std::vector<Stats> m_stats{};
+	std::ofstream m_trace{};
+	bool m_first_event{true};
+};
+} // namespace lvk
@@ -1,11 +1,15 @@
 #pragma once
-#include <array>
+#include <cstddef>
+#include <vector>
 
 namespace lvk {
-// Number of virtual frames.
+// Default number of virtual frames.
 inline constexpr std::size_t resource_buffering_v{2};
+// Maximum number of virtual frames that can be chosen at startup.
+inline constexpr std::size_t max_resource_buffering_v{4};
 
-// Alias for N-buffered resources.
+// Alias for N-buffered resources, sized to the number of virtual frames
+// (chosen at startup).
 template <typename Type>
-using Buffered = std::array<Type, resource_buffering_v>;
+using Buffered = std::vector<Type>;
 } // namespace lvk
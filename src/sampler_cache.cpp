@@ -0,0 +1,91 @@
+#include <sampler_cache.hpp>
+#include <bit>
+#include <functional>
+#include <type_traits>
+
+namespace lvk {
+namespace {
+// boost::hash_combine.
+void hash_combine(std::size_t& out, std::size_t const hash) {
+	out ^= hash + 0x9e3779b9 + (out << 6) + (out >> 2);
+}
+
+template <typename Type>
+[[nodiscard]] auto to_hashable(Type const value) -> std::uint64_t {
+	if constexpr (std::is_same_v<Type, float>) {
+		// -0.0f == 0.0f: equal keys must hash equally.
+		return value == 0.0f ? 0 : std::bit_cast<std::uint32_t>(value);
+	} else if constexpr (std::is_enum_v<Type>) {
+		return static_cast<std::uint64_t>(
+			static_cast<std::underlying_type_t<Type>>(value));
+	} else {
+		return static_cast<std::uint64_t>(value);
+	}
+}
+} // namespace
+
+auto create_shared_sampler(vk::Device const device,
+						   vk::SamplerCreateInfo const& info)
+	-> SharedSampler {
+	return std::make_shared<vk::UniqueSampler const>(
+		device.createSamplerUnique(info));
+}
+
+auto SamplerCache::acquire(vk::SamplerCreateInfo const& info)
+	-> SharedSampler {
+	auto lock = std::scoped_lock{m_mutex};
+	// chained structs (eg reduction modes) are not part of the key.
+	if (info.pNext != nullptr) {
+		++m_misses;
+		return create_shared_sampler(m_device, info);
+	}
+
+	auto& entry = m_samplers[info];
+	if (auto ret = entry.lock()) {
+		++m_hits;
+		return ret;
+	}
+	++m_misses;
+	// drop entries whose samplers have been destroyed.
+	std::erase_if(m_samplers, [&entry](auto const& pair) {
+		return &pair.second != &entry && pair.second.expired();
+	});
+	auto ret = create_shared_sampler(m_device, info);
+	entry = ret;
+	return ret;
+}
+
+auto SamplerCache::get_stats() const -> SamplerCacheStats {
+	auto lock = std::scoped_lock{m_mutex};
+	auto ret = SamplerCacheStats{.hits = m_hits, .misses = m_misses};
+	for (auto const& [_, sampler] : m_samplers) {
+		if (!sampler.expired()) { ++ret.live; }
+	}
+	return ret;
+}
+
+auto SamplerCache::Hasher::operator()(vk::SamplerCreateInfo const& info) const
+	-> std::size_t {
+	auto ret = std::size_t{};
+	auto const add = [&ret](auto const value) {
+		hash_combine(ret, std::hash<std::uint64_t>{}(to_hashable(value)));
+	};
+	add(static_cast<VkSamplerCreateFlags>(info.flags));
+	add(info.magFilter);
+	add(info.minFilter);
+	add(info.mipmapMode);
+	add(info.addressModeU);
+	add(info.addressModeV);
+	add(info.addressModeW);
+	add(info.mipLodBias);
+	add(info.anisotropyEnable);
+	add(info.maxAnisotropy);
+	add(info.compareEnable);
+	add(info.compareOp);
+	add(info.minLod);
+	add(info.maxLod);
+	add(info.borderColor);
+	add(info.unnormalizedCoordinates);
+	return ret;
+}
+} // namespace lvk
@@ -0,0 +1,56 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace lvk {
+// Reference-counted sampler, destroyed along with its last owner.
+using SharedSampler = std::shared_ptr<vk::UniqueSampler const>;
+
+// creates a sampler that is not shared with any other owner.
+[[nodiscard]] auto create_shared_sampler(vk::Device device,
+										 vk::SamplerCreateInfo const& info)
+	-> SharedSampler;
+
+struct SamplerCacheStats {
+	// acquires that returned an existing sampler.
+	std::uint64_t hits{};
+	// acquires that created a sampler.
+	std::uint64_t misses{};
+	// samplers currently owned by at least one handle.
+	std::uint64_t live{};
+};
+
+// Deduplicates samplers by their create info: textures with the same
+// sampling parameters share one vk::Sampler, keeping well below
+// maxSamplerAllocationCount. The cache only observes the samplers it hands
+// out, so it may be destroyed before them. Thread-safe.
+class SamplerCache {
+  public:
+	explicit SamplerCache(vk::Device device) : m_device(device) {}
+
+	// returns the sampler for info, creating it if no handle to one is
+	// alive. create infos with a pNext chain are never shared.
+	[[nodiscard]] auto acquire(vk::SamplerCreateInfo const& info)
+		-> SharedSampler;
+
+	[[nodiscard]] auto get_stats() const -> SamplerCacheStats;
+
+  private:
+	struct Hasher {
+		[[nodiscard]] auto operator()(vk::SamplerCreateInfo const& info) const
+			-> std::size_t;
+	};
+
+	using WeakSampler = std::weak_ptr<vk::UniqueSampler const>;
+
+	vk::Device m_device{};
+	mutable std::mutex m_mutex{};
+	std::unordered_map<vk::SamplerCreateInfo, WeakSampler, Hasher>
+		m_samplers{};
+	std::uint64_t m_hits{};
+	std::uint64_t m_misses{};
+};
+} // namespace lvk
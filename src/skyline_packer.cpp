@@ -0,0 +1,93 @@
+#include <skyline_packer.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace lvk {
+SkylinePacker::SkylinePacker(glm::uvec2 const size) : m_size(size) {
+	m_skyline.push_back(Segment{.width = m_size.x});
+}
+
+auto SkylinePacker::insert(glm::uvec2 const size)
+	-> std::optional<glm::uvec2> {
+	if (size.x == 0 || size.y == 0) { return {}; }
+
+	// lowest far edge, then narrowest segment: keeps gaps small.
+	auto best_index = std::optional<std::size_t>{};
+	auto best_bottom = std::numeric_limits<std::uint32_t>::max();
+	auto best_width = std::numeric_limits<std::uint32_t>::max();
+	auto best_y = std::uint32_t{};
+	for (auto index = 0uz; index < m_skyline.size(); ++index) {
+		auto const y = fit(index, size);
+		if (!y) { continue; }
+		auto const bottom = *y + size.y;
+		auto const width = m_skyline[index].width;
+		if (bottom < best_bottom ||
+			(bottom == best_bottom && width < best_width)) {
+			best_index = index;
+			best_bottom = bottom;
+			best_width = width;
+			best_y = *y;
+		}
+	}
+	if (!best_index) { return {}; }
+
+	auto const x = m_skyline[*best_index].x;
+	add_segment(*best_index,
+				Segment{.x = x, .y = best_bottom, .width = size.x});
+	m_used_area += std::uint64_t{size.x} * size.y;
+	return glm::uvec2{x, best_y};
+}
+
+auto SkylinePacker::get_occupancy() const -> float {
+	auto const area = std::uint64_t{m_size.x} * m_size.y;
+	if (area == 0) { return 0.0f; }
+	return static_cast<float>(static_cast<double>(m_used_area) /
+							  static_cast<double>(area));
+}
+
+auto SkylinePacker::fit(std::size_t index, glm::uvec2 const size) const
+	-> std::optional<std::uint32_t> {
+	auto const x = m_skyline[index].x;
+	if (x + size.x > m_size.x) { return {}; }
+	// the rectangle rests on the highest segment it spans.
+	auto y = std::uint32_t{};
+	for (auto remaining = size.x; remaining > 0; ++index) {
+		auto const& segment = m_skyline[index];
+		y = std::max(y, segment.y);
+		if (y + size.y > m_size.y) { return {}; }
+		remaining -= std::min(remaining, segment.width);
+	}
+	return y;
+}
+
+void SkylinePacker::add_segment(std::size_t const index,
+								Segment const& segment) {
+	m_skyline.insert(m_skyline.begin() + static_cast<std::ptrdiff_t>(index),
+					 segment);
+	// shrink / remove the segments now covered by the new one.
+	auto const end = segment.x + segment.width;
+	for (auto i = index + 1; i < m_skyline.size();) {
+		auto& next = m_skyline[i];
+		if (next.x >= end) { break; }
+		auto const overlap = end - next.x;
+		if (overlap < next.width) {
+			next.x += overlap;
+			next.width -= overlap;
+			break;
+		}
+		m_skyline.erase(m_skyline.begin() + static_cast<std::ptrdiff_t>(i));
+	}
+	// merge neighbours at the same height.
+	for (auto i = 0uz; i + 1 < m_skyline.size();) {
+		auto& lhs = m_skyline[i];
+		auto const& rhs = m_skyline[i + 1];
+		if (lhs.y != rhs.y) {
+			++i;
+			continue;
+		}
+		lhs.width += rhs.width;
+		m_skyline.erase(m_skyline.begin() +
+						static_cast<std::ptrdiff_t>(i + 1));
+	}
+}
+} // namespace lvk
@@ -0,0 +1,46 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace lvk {
+// Skyline (bottom-left) rectangle packer: the top edge of all packed
+// rectangles is tracked as a list of horizontal segments, and each
+// rectangle is placed where its far edge ends lowest. Only tracks
+// positions: the texels live elsewhere.
+class SkylinePacker {
+  public:
+	explicit SkylinePacker(glm::uvec2 size);
+
+	// returns the top-left corner of a free rectangle of size, or nullopt if
+	// none is left.
+	[[nodiscard]] auto insert(glm::uvec2 size) -> std::optional<glm::uvec2>;
+
+	[[nodiscard]] auto get_size() const -> glm::uvec2 { return m_size; }
+	// area of all inserted rectangles.
+	[[nodiscard]] auto get_used_area() const -> std::uint64_t {
+		return m_used_area;
+	}
+	// used area / total area.
+	[[nodiscard]] auto get_occupancy() const -> float;
+
+  private:
+	// top edge of the packed area over [x, x + width).
+	struct Segment {
+		std::uint32_t x{};
+		std::uint32_t y{};
+		std::uint32_t width{};
+	};
+
+	// y a rectangle of size would be placed at, starting at segment index.
+	[[nodiscard]] auto fit(std::size_t index, glm::uvec2 size) const
+		-> std::optional<std::uint32_t>;
+	void add_segment(std::size_t index, Segment const& segment);
+
+	glm::uvec2 m_size{};
+	// sorted by x, covering [0, width).
+	std::vector<Segment> m_skyline{};
+	std::uint64_t m_used_area{};
+};
+} // namespace lvk
@@ -0,0 +1,89 @@
+#include <staging_ring.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+[[nodiscard]] constexpr auto align_up(vk::DeviceSize const value,
+									  vk::DeviceSize const alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+StagingRing::StagingRing(VmaAllocator allocator,
+						 std::uint32_t const queue_family,
+						 vk::DeviceSize const capacity) {
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = allocator,
+		.usage = vk::BufferUsageFlagBits::eTransferSrc,
+		.queue_family = queue_family,
+	};
+	m_buffer =
+		vma::create_buffer(buffer_ci, vma::BufferMemoryType::Host, capacity);
+	if (!m_buffer.get().buffer) {
+		throw std::runtime_error{"Failed to create staging ring Buffer"};
+	}
+}
+
+auto StagingRing::allocate(vk::DeviceSize const size,
+						   vk::DeviceSize alignment)
+	-> std::optional<StagingSlice> {
+	auto const capacity = get_capacity();
+	alignment = std::max(alignment, vk::DeviceSize{1});
+	if (size == 0 || size > capacity) { return {}; }
+	if (m_used == 0) {
+		// start over at the beginning for maximum contiguous space.
+		m_head = m_tail = 0;
+	} else if (m_used == capacity) {
+		return {};
+	}
+
+	auto offset = align_up(m_head, alignment);
+	auto end = offset + size;
+	if (m_head < m_tail) {
+		// free space is [head, tail).
+		if (end > m_tail) { return {}; }
+	} else if (end > capacity) {
+		// free space is [head, capacity) and [0, tail): wrap around.
+		offset = 0;
+		end = size;
+		if (end > m_tail) { return {}; }
+		// the space skipped at the end remains in use until this is retired.
+		m_pending += capacity - m_head;
+		m_used += capacity - m_head;
+		m_head = 0;
+	}
+
+	m_pending += end - m_head;
+	m_used += end - m_head;
+	m_head = end;
+	auto const mapped = m_buffer.get().mapped_span();
+	return StagingSlice{
+		.buffer = m_buffer.get().buffer,
+		.offset = offset,
+		.bytes = mapped.subspan(offset, size),
+	};
+}
+
+void StagingRing::retire(std::uint64_t const value) {
+	if (m_pending == 0) { return; }
+	m_regions.push_back(
+		Region{.end = m_head, .bytes = m_pending, .value = value});
+	m_pending = 0;
+}
+
+void StagingRing::reclaim(std::uint64_t const completed_value) {
+	// regions are freed in allocation order.
+	while (!m_regions.empty() && m_regions.front().value <= completed_value) {
+		auto const& region = m_regions.front();
+		m_tail = region.end;
+		m_used -= region.bytes;
+		m_regions.pop_front();
+	}
+}
+
+auto StagingRing::oldest_value() const -> std::optional<std::uint64_t> {
+	if (m_regions.empty()) { return {}; }
+	return m_regions.front().value;
+}
+} // namespace lvk
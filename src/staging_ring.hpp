@@ -0,0 +1,69 @@
+#pragma once
+#include <vma.hpp>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+
+namespace lvk {
+// Sub-allocation of a StagingRing.
+struct StagingSlice {
+	vk::Buffer buffer{};
+	vk::DeviceSize offset{};
+	std::span<std::byte> bytes{};
+};
+
+// Staging memory for one upload.
+struct StagingAllocation {
+	StagingSlice slice{};
+	// fallback for uploads that don't fit in the ring.
+	vma::Buffer dedicated{};
+};
+
+// Persistently mapped Host Buffer that uploads sub-allocate staging memory
+// from. Allocations are retired against a timeline value, and the ring
+// wraps around as the GPU reaches those values.
+class StagingRing {
+  public:
+	static constexpr vk::DeviceSize default_capacity_v{16 * 1024 * 1024};
+
+	explicit StagingRing(VmaAllocator allocator, std::uint32_t queue_family,
+						 vk::DeviceSize capacity = default_capacity_v);
+
+	// returns nullopt if size does not fit in the free space right now.
+	[[nodiscard]] auto allocate(vk::DeviceSize size, vk::DeviceSize alignment)
+		-> std::optional<StagingSlice>;
+
+	// allocations since the previous call are in use until the timeline
+	// reaches value. pass 0 if they are not in use anymore.
+	void retire(std::uint64_t value);
+	// frees retired allocations whose value has been reached.
+	void reclaim(std::uint64_t completed_value);
+
+	// value to wait for to free the oldest retired allocations.
+	[[nodiscard]] auto oldest_value() const -> std::optional<std::uint64_t>;
+
+	[[nodiscard]] auto get_capacity() const -> vk::DeviceSize {
+		return m_buffer.get().size;
+	}
+	[[nodiscard]] auto get_used() const -> vk::DeviceSize { return m_used; }
+
+  private:
+	struct Region {
+		vk::DeviceSize end{};
+		// includes alignment padding and space skipped when wrapping.
+		vk::DeviceSize bytes{};
+		std::uint64_t value{};
+	};
+
+	vma::Buffer m_buffer{};
+	// next write offset.
+	vk::DeviceSize m_head{};
+	// start of the oldest allocation in use.
+	vk::DeviceSize m_tail{};
+	vk::DeviceSize m_used{};
+	// bytes allocated since the last retire().
+	vk::DeviceSize m_pending{};
+	std::deque<Region> m_regions{};
+};
+} // namespace lvk
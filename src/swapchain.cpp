@@ -8,7 +8,7 @@
 
 namespace lvk {
 namespace {
-constexpr std::uint32_t min_images_v{3};
+constexpr std::uint32_t min_images_v{2};
 
 constexpr auto srgb_formats_v = std::array{
 	vk::Format::eR8G8B8A8Srgb,
@@ -57,15 +57,49 @@ get_image_extent(vk::SurfaceCapabilitiesKHR const& capabilities,
 }
 
 [[nodiscard]] constexpr auto
-get_image_count(vk::SurfaceCapabilitiesKHR const& capabilities)
-	-> std::uint32_t {
+get_image_count(vk::SurfaceCapabilitiesKHR const& capabilities,
+				std::uint32_t desired) -> std::uint32_t {
+	desired = std::max(desired, min_images_v);
+	// maxImageCount is 0 if there is no limit.
 	if (capabilities.maxImageCount < capabilities.minImageCount) {
-		return std::max(min_images_v, capabilities.minImageCount);
+		return std::max(desired, capabilities.minImageCount);
 	}
-	return std::clamp(min_images_v, capabilities.minImageCount,
+	return std::clamp(desired, capabilities.minImageCount,
 					  capabilities.maxImageCount);
 }
 
+// the desired mode followed by its fallbacks, closest behaviour first.
+[[nodiscard]] constexpr auto
+get_present_mode_chain(vk::PresentModeKHR const desired)
+	-> std::array<vk::PresentModeKHR, 3> {
+	using enum vk::PresentModeKHR;
+	switch (desired) {
+	// no vsync: prefer not blocking over not tearing.
+	case eImmediate: return {eImmediate, eMailbox, eFifoRelaxed};
+	// no tearing: never fall back to Immediate.
+	case eMailbox: return {eMailbox, eFifo, eFifo};
+	case eFifoRelaxed: return {eFifoRelaxed, eFifo, eFifo};
+	default: return {eFifo, eFifo, eFifo};
+	}
+}
+
+[[nodiscard]] auto
+get_present_mode(std::span<vk::PresentModeKHR const> supported,
+				 vk::PresentModeKHR const desired) -> vk::PresentModeKHR {
+	for (auto const mode : get_present_mode_chain(desired)) {
+		if (std::ranges::find(supported, mode) != supported.end()) {
+			return mode;
+		}
+	}
+	// eFifo is guaranteed to be supported.
+	return vk::PresentModeKHR::eFifo;
+}
+
+[[nodiscard]] auto to_ms(PresentLatency::Clock::duration const duration)
+	-> double {
+	return std::chrono::duration<double, std::milli>{duration}.count();
+}
+
 // throws if result is not eSuccess.
 void require_success(vk::Result const result, char const* error_msg) {
 	if (result != vk::Result::eSuccess) { throw std::runtime_error{error_msg}; }
@@ -83,8 +117,9 @@ auto needs_recreation(vk::Result const result) -> bool {
 } // namespace
 
 Swapchain::Swapchain(vk::Device const device, Gpu const& gpu,
-					 vk::SurfaceKHR const surface, glm::ivec2 const size)
-	: m_device(device), m_gpu(gpu) {
+					 vk::SurfaceKHR const surface, glm::ivec2 const size,
+					 Policy const& policy)
+	: m_device(device), m_gpu(gpu), m_policy(policy) {
 	auto const surface_format =
 		get_surface_format(m_gpu.device.getSurfaceFormatsKHR(surface));
 	m_ci.setSurface(surface)
@@ -92,9 +127,7 @@ Swapchain::Swapchain(vk::Device const device, Gpu const& gpu,
 		.setImageColorSpace(surface_format.colorSpace)
 		.setImageArrayLayers(1)
 		// Swapchain images will be used as color attachments (render targets).
-		.setImageUsage(vk::ImageUsageFlagBits::eColorAttachment)
-		// eFifo is guaranteed to be supported.
-		.setPresentMode(vk::PresentModeKHR::eFifo);
+		.setImageUsage(vk::ImageUsageFlagBits::eColorAttachment);
 	if (!recreate(size)) {
 		throw std::runtime_error{"Failed to create Vulkan Swapchain"};
 	}
@@ -106,29 +139,66 @@ auto Swapchain::recreate(glm::ivec2 size) -> bool {
 
 	auto const capabilities =
 		m_gpu.device.getSurfaceCapabilitiesKHR(m_ci.surface);
+	auto const present_modes =
+		m_gpu.device.getSurfacePresentModesKHR(m_ci.surface);
+	auto const present_mode =
+		get_present_mode(present_modes, m_policy.present_mode);
+	if (m_latency.frames > 0 && present_mode != m_ci.presentMode) {
+		// latency is tracked per present mode.
+		log_latency();
+		m_latency = {};
+	}
 	m_ci.setImageExtent(get_image_extent(capabilities, size))
-		.setMinImageCount(get_image_count(capabilities))
+		.setMinImageCount(get_image_count(capabilities, m_policy.image_count))
+		.setPresentMode(present_mode)
 		.setOldSwapchain(m_swapchain ? *m_swapchain : vk::SwapchainKHR{})
 		.setQueueFamilyIndices(m_gpu.queue_family);
 	assert(m_ci.imageExtent.width > 0 && m_ci.imageExtent.height > 0 &&
 		   m_ci.minImageCount >= min_images_v);
 
-	// wait for the device to be idle before destroying the current swapchain.
-	m_device.waitIdle();
-	m_swapchain = m_device.createSwapchainKHRUnique(m_ci);
+	auto swapchain = m_device.createSwapchainKHRUnique(m_ci);
+	if (m_swapchain) {
+		// frames presented so far may still be in flight: instead of waiting
+		// for the device to be idle, retire the current Swapchain (and its
+		// image views) until one more frame has been drawn. presentation is
+		// not tracked by the timeline, the extra frame gives the presentation
+		// engine time to release the last presented image.
+		m_retired.push_back(Retired{
+			.swapchain = std::move(m_swapchain),
+			.image_views = std::move(m_image_views),
+			.timeline_value = m_presented_value + 1,
+		});
+	}
+	m_swapchain = std::move(swapchain);
 	m_image_index.reset();
 
 	populate_images();
 	create_image_views();
 
 	size = get_size();
-	spdlog::info("[lvk] Swapchain [{}x{}]", size.x, size.y);
+	spdlog::info("[lvk] Swapchain [{}x{}] {}, {} images", size.x, size.y,
+				 vk::to_string(m_ci.presentMode), m_images.size());
 	return true;
 }
 
+auto Swapchain::recreate(glm::ivec2 const size, Policy const& policy)
+	-> bool {
+	m_policy = policy;
+	return recreate(size);
+}
+
+void Swapchain::log_latency() const {
+	spdlog::info("[lvk] {} acquire to present: {:.3f}ms average, {:.3f}ms "
+				 "max, {} frames",
+				 vk::to_string(m_ci.presentMode), to_ms(m_latency.average()),
+				 to_ms(m_latency.max), m_latency.frames);
+}
+
 auto Swapchain::acquire_next_image(vk::Semaphore const to_signal)
 	-> std::optional<RenderTarget> {
 	assert(!m_image_index);
+	// acquisition itself may block, depending on the present mode.
+	m_latency.acquired = PresentLatency::Clock::now();
 	static constexpr auto timeout_v = std::numeric_limits<std::uint64_t>::max();
 	// avoid VulkanHPP ErrorOutOfDateKHR exceptions by using alternate API that
 	// returns a Result.
@@ -155,8 +225,8 @@ auto Swapchain::base_barrier() const -> vk::ImageMemoryBarrier2 {
 	return ret;
 }
 
-auto Swapchain::present(vk::Queue const queue, vk::Semaphore const to_wait)
-	-> bool {
+auto Swapchain::present(vk::Queue const queue, vk::Semaphore const to_wait,
+						std::uint64_t const drawn_value) -> bool {
 	auto const image_index = static_cast<std::uint32_t>(m_image_index.value());
 	auto present_info = vk::PresentInfoKHR{};
 	present_info.setSwapchains(*m_swapchain)
@@ -165,9 +235,23 @@ auto Swapchain::present(vk::Queue const queue, vk::Semaphore const to_wait)
 	// avoid VulkanHPP ErrorOutOfDateKHR exceptions by using alternate API.
 	auto const result = queue.presentKHR(&present_info);
 	m_image_index.reset();
+	m_presented_value = drawn_value;
+
+	m_latency.presented = PresentLatency::Clock::now();
+	auto const latency = m_latency.presented - m_latency.acquired;
+	m_latency.total += latency;
+	m_latency.max = std::max(m_latency.max, latency);
+	++m_latency.frames;
+
 	return !needs_recreation(result);
 }
 
+void Swapchain::destroy_retired(std::uint64_t const completed_value) {
+	std::erase_if(m_retired, [completed_value](Retired const& retired) {
+		return retired.timeline_value <= completed_value;
+	});
+}
+
 void Swapchain::populate_images() {
 	// we use the more verbose two-call API to avoid assigning m_images to a new
 	// vector on every call.
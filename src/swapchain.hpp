@@ -2,16 +2,47 @@
 #include <glm/vec2.hpp>
 #include <gpu.hpp>
 #include <render_target.hpp>
+#include <chrono>
 #include <optional>
 #include <vector>
 
 namespace lvk {
+struct SwapchainPolicy {
+	// desired present mode, falls back to the closest supported one.
+	vk::PresentModeKHR present_mode{vk::PresentModeKHR::eFifo};
+	// desired number of images, clamped to the surface capabilities.
+	std::uint32_t image_count{3};
+};
+
+// acquire-to-present latency (CPU) of presented frames.
+struct PresentLatency {
+	using Clock = std::chrono::steady_clock;
+
+	[[nodiscard]] auto average() const -> Clock::duration {
+		if (frames == 0) { return {}; }
+		return total / static_cast<Clock::rep>(frames);
+	}
+
+	// timestamps of the latest frame.
+	Clock::time_point acquired{};
+	Clock::time_point presented{};
+
+	Clock::duration total{};
+	Clock::duration max{};
+	std::uint64_t frames{};
+};
+
 class Swapchain {
   public:
+	using Policy = SwapchainPolicy;
+
 	explicit Swapchain(vk::Device device, Gpu const& gpu,
-					   vk::SurfaceKHR surface, glm::ivec2 size);
+					   vk::SurfaceKHR surface, glm::ivec2 size,
+					   Policy const& policy);
 
 	auto recreate(glm::ivec2 size) -> bool;
+	// switches to a new policy.
+	auto recreate(glm::ivec2 size, Policy const& policy) -> bool;
 
 	[[nodiscard]] auto get_size() const -> glm::ivec2 {
 		return {m_ci.imageExtent.width, m_ci.imageExtent.height};
@@ -21,24 +52,62 @@ class Swapchain {
 		return m_ci.imageFormat;
 	}
 
+	[[nodiscard]] auto get_policy() const -> Policy const& { return m_policy; }
+
+	// the supported present mode chosen for the current policy.
+	[[nodiscard]] auto get_present_mode() const -> vk::PresentModeKHR {
+		return m_ci.presentMode;
+	}
+
+	[[nodiscard]] auto get_image_count() const -> std::size_t {
+		return m_images.size();
+	}
+
+	// reset whenever the present mode changes.
+	[[nodiscard]] auto get_latency() const -> PresentLatency const& {
+		return m_latency;
+	}
+
+	void log_latency() const;
+
 	[[nodiscard]] auto acquire_next_image(vk::Semaphore to_signal)
 		-> std::optional<RenderTarget>;
 
 	[[nodiscard]] auto base_barrier() const -> vk::ImageMemoryBarrier2;
 
-	[[nodiscard]] auto present(vk::Queue queue, vk::Semaphore to_wait) -> bool;
+	// drawn_value: value of the render timeline signalled by the submission
+	// that rendered the presented image.
+	[[nodiscard]] auto present(vk::Queue queue, vk::Semaphore to_wait,
+							   std::uint64_t drawn_value) -> bool;
+
+	// destroys retired Swapchains whose frames have been drawn.
+	void destroy_retired(std::uint64_t completed_value);
 
   private:
+	// a replaced Swapchain, kept alive until the render timeline reaches
+	// timeline_value.
+	struct Retired {
+		vk::UniqueSwapchainKHR swapchain{};
+		std::vector<vk::UniqueImageView> image_views{};
+		std::uint64_t timeline_value{};
+	};
+
 	void populate_images();
 	void create_image_views();
 
 	vk::Device m_device{};
 	Gpu m_gpu{};
+	Policy m_policy{};
+	PresentLatency m_latency{};
 
 	vk::SwapchainCreateInfoKHR m_ci{};
 	vk::UniqueSwapchainKHR m_swapchain{};
 	std::vector<vk::Image> m_images{};
 	std::vector<vk::UniqueImageView> m_image_views{};
 	std::optional<std::size_t> m_image_index{};
+
+	// drawn value of the latest presented frame.
+	std::uint64_t m_presented_value{};
+	std::vector<Retired> m_retired{};
 };
 } // namespace lvk
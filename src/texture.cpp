@@ -1,51 +1,51 @@
 #include <texture.hpp>
-#include <array>
 
 namespace lvk {
 namespace {
-// 4-channels.
-constexpr auto white_pixel_v = std::array{std::byte{0xff}, std::byte{0xff},
-										  std::byte{0xff}, std::byte{0xff}};
-// fallback bitmap.
-constexpr auto white_bitmap_v = Bitmap{
-	.bytes = white_pixel_v,
-	.size = {1, 1},
-};
+[[nodiscard]] auto get_sampler(vk::Device const device,
+							   vk::SamplerCreateInfo const& info,
+							   SamplerCache* samplers) -> SharedSampler {
+	if (samplers == nullptr) { return create_shared_sampler(device, info); }
+	return samplers->acquire(info);
+}
 } // namespace
 
-Texture::Texture(CreateInfo create_info) {
-	if (create_info.bitmap.bytes.empty() || create_info.bitmap.size.x <= 0 ||
-		create_info.bitmap.size.y <= 0) {
-		create_info.bitmap = white_bitmap_v;
-	}
+Texture::Texture(vk::Device const device, vma::Image image,
+				 vk::SamplerCreateInfo const& sampler,
+				 SamplerCache* samplers)
+	: m_image(std::move(image)) {
+	create_view(device);
+	m_sampler = get_sampler(device, sampler, samplers);
+}
 
-	auto const image_ci = vma::ImageCreateInfo{
-		.allocator = create_info.allocator,
-		.queue_family = create_info.queue_family,
-	};
-	m_image = vma::create_sampled_image(
-		image_ci, std::move(create_info.command_block), create_info.bitmap);
+void Texture::refresh_view(DeferredQueue& deferred) {
+	auto const device = m_view.getOwner();
+	deferred.release(std::move(m_view));
+	create_view(device);
+}
 
+void Texture::create_view(vk::Device const device) {
 	auto image_view_ci = vk::ImageViewCreateInfo{};
 	auto subresource_range = vk::ImageSubresourceRange{};
 	subresource_range.setAspectMask(vk::ImageAspectFlagBits::eColor)
-		.setLayerCount(1)
+		.setLayerCount(m_image.get().layers)
 		.setLevelCount(m_image.get().levels);
 
+	auto const view_type = m_image.get().layers > 1
+							   ? vk::ImageViewType::e2DArray
+							   : vk::ImageViewType::e2D;
 	image_view_ci.setImage(m_image.get().image)
-		.setViewType(vk::ImageViewType::e2D)
+		.setViewType(view_type)
 		.setFormat(m_image.get().format)
 		.setSubresourceRange(subresource_range);
-	m_view = create_info.device.createImageViewUnique(image_view_ci);
-
-	m_sampler = create_info.device.createSamplerUnique(create_info.sampler);
+	m_view = device.createImageViewUnique(image_view_ci);
 }
 
 auto Texture::descriptor_info() const -> vk::DescriptorImageInfo {
 	auto ret = vk::DescriptorImageInfo{};
 	ret.setImageView(*m_view)
 		.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-		.setSampler(*m_sampler);
+		.setSampler(**m_sampler);
 	return ret;
 }
 } // namespace lvk
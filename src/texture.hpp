@@ -1,7 +1,20 @@
 #pragma once
+#include <bitmap.hpp>
+#include <deferred_queue.hpp>
+#include <sampler_cache.hpp>
 #include <vma.hpp>
+#include <array>
 
 namespace lvk {
+// 4-channels.
+constexpr auto white_pixel_v = std::array{std::byte{0xff}, std::byte{0xff},
+										  std::byte{0xff}, std::byte{0xff}};
+// fallback bitmap.
+constexpr auto white_bitmap_v = Bitmap{
+	.bytes = white_pixel_v,
+	.size = {1, 1},
+};
+
 [[nodiscard]] constexpr auto
 create_sampler_ci(vk::SamplerAddressMode const wrap, vk::Filter const filter) {
 	auto ret = vk::SamplerCreateInfo{};
@@ -12,34 +25,36 @@ create_sampler_ci(vk::SamplerAddressMode const wrap, vk::Filter const filter) {
 		.setMagFilter(filter)
 		.setMaxLod(VK_LOD_CLAMP_NONE)
 		.setBorderColor(vk::BorderColor::eFloatTransparentBlack)
-		.setMipmapMode(vk::SamplerMipmapMode::eNearest);
+		.setMipmapMode(filter == vk::Filter::eLinear
+						   ? vk::SamplerMipmapMode::eLinear
+						   : vk::SamplerMipmapMode::eNearest);
 	return ret;
 }
 
 constexpr auto sampler_ci_v = create_sampler_ci(
 	vk::SamplerAddressMode::eClampToEdge, vk::Filter::eLinear);
 
-struct TextureCreateInfo {
-	vk::Device device;
-	VmaAllocator allocator;
-	std::uint32_t queue_family;
-	CommandBlock command_block;
-	Bitmap bitmap;
-
-	vk::SamplerCreateInfo sampler{sampler_ci_v};
-};
-
 class Texture {
   public:
-	using CreateInfo = TextureCreateInfo;
-
-	explicit Texture(CreateInfo create_info);
+	// takes ownership of an already uploaded sampled image, viewed as a 2D
+	// array if it has multiple layers.
+	explicit Texture(vk::Device device, vma::Image image,
+					 vk::SamplerCreateInfo const& sampler = sampler_ci_v,
+					 SamplerCache* samplers = nullptr);
 
 	[[nodiscard]] auto descriptor_info() const -> vk::DescriptorImageInfo;
 
+	// for the Defragmenter to move the image in place.
+	[[nodiscard]] auto get_image() -> vma::Image& { return m_image; }
+	// recreates the image view after the image has been moved, the old view
+	// is released into deferred (descriptors must be rewritten).
+	void refresh_view(DeferredQueue& deferred);
+
   private:
+	void create_view(vk::Device device);
+
 	vma::Image m_image{};
 	vk::UniqueImageView m_view{};
-	vk::UniqueSampler m_sampler{};
+	SharedSampler m_sampler{};
 };
 } // namespace lvk
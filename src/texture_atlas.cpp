@@ -0,0 +1,249 @@
+#include <mip_chain.hpp>
+#include <spdlog/spdlog.h>
+#include <texture_atlas.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+constexpr auto format_v = vk::Format::eR8G8B8A8Srgb;
+constexpr std::size_t channels_v{4};
+
+[[nodiscard]] auto create_subresource_range(std::uint32_t const levels) {
+	auto ret = vk::ImageSubresourceRange{};
+	ret.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLevelCount(levels)
+		.setLayerCount(1);
+	return ret;
+}
+
+// writes bitmap into dst (extent texels) at offset, clamping reads to its
+// edges: the rest of dst repeats the nearest edge texel.
+void extrude(Bitmap const& bitmap, std::span<std::byte> dst,
+			 glm::uvec2 const extent, std::uint32_t const offset) {
+	auto const size = glm::uvec2{bitmap.size};
+	auto const src_stride = std::size_t{size.x} * channels_v;
+	auto const dst_stride = std::size_t{extent.x} * channels_v;
+	auto const right = extent.x - offset - size.x;
+	for (auto y = 0u; y < extent.y; ++y) {
+		auto const src_y = std::min(y - std::min(y, offset), size.y - 1);
+		auto const* src = bitmap.bytes.data() + src_y * src_stride;
+		auto* out = dst.data() + y * dst_stride;
+		for (auto x = 0u; x < offset; ++x, out += channels_v) {
+			std::memcpy(out, src, channels_v);
+		}
+		std::memcpy(out, src, src_stride);
+		out += src_stride;
+		auto const* last = src + src_stride - channels_v;
+		for (auto x = 0u; x < right; ++x, out += channels_v) {
+			std::memcpy(out, last, channels_v);
+		}
+	}
+}
+} // namespace
+
+TextureAtlas::TextureAtlas(CreateInfo const& create_info)
+	: m_create_info(create_info) {
+	auto const levels = m_create_info.levels;
+	if (levels == 0 || levels > 16 || m_create_info.max_pages == 0) {
+		throw std::runtime_error{"Invalid texture atlas"};
+	}
+	m_alignment = 1u << (levels - 1);
+	m_gutter = m_create_info.padding << (levels - 1);
+	if (m_create_info.page_size == 0 ||
+		m_create_info.page_size % m_alignment != 0) {
+		throw std::runtime_error{"Invalid texture atlas page size"};
+	}
+}
+
+auto TextureAtlas::insert(Bitmap const& bitmap) -> std::optional<AtlasEntry> {
+	auto const valid = bitmap.size.x > 0 && bitmap.size.y > 0 &&
+					   bitmap.bytes.size() >=
+						   static_cast<std::size_t>(bitmap.size.x) *
+							   static_cast<std::size_t>(bitmap.size.y) *
+							   channels_v;
+	if (!valid) {
+		++m_stats.rejections;
+		return {};
+	}
+
+	// the gutter on each side, rounded up to whole cells.
+	auto const padded = glm::uvec2{bitmap.size} + 2u * m_gutter;
+	auto const cells = (padded + m_alignment - 1u) / m_alignment;
+	auto const placement = place(cells);
+	if (!placement) {
+		++m_stats.rejections;
+		return {};
+	}
+	auto const [page_index, cell] = *placement;
+	auto const texel = cell * m_alignment;
+	stage(m_pages[page_index], bitmap, texel);
+	++m_stats.insertions;
+
+	auto const page_size = static_cast<float>(m_create_info.page_size);
+	auto const uv_min = glm::vec2{texel + m_gutter} / page_size;
+	return AtlasEntry{
+		.page = page_index,
+		.uv_min = uv_min,
+		.uv_max = uv_min + glm::vec2{bitmap.size} / page_size,
+	};
+}
+
+void TextureAtlas::record(vk::CommandBuffer const command_buffer,
+						  DeferredQueue& deferred) {
+	if (m_pending.empty()) { return; }
+
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = m_create_info.allocator,
+		.usage = vk::BufferUsageFlagBits::eTransferSrc,
+		.queue_family = m_create_info.queue_family,
+	};
+	auto staging = vma::create_buffer(buffer_ci, vma::BufferMemoryType::Host,
+									  m_pending.size());
+	if (!staging.get().buffer) {
+		// retried on the next record().
+		spdlog::error("[TextureAtlas] Failed to create staging Buffer");
+		return;
+	}
+	std::memcpy(staging.get().mapped, m_pending.data(), m_pending.size());
+	vma::flush_buffer(staging.get(), 0, m_pending.size());
+
+	auto const subresource_range =
+		create_subresource_range(m_create_info.levels);
+	auto barriers = std::vector<vk::ImageMemoryBarrier2>{};
+	barriers.reserve(m_pages.size());
+	for (auto& page : m_pages) {
+		if (page.regions.empty()) { continue; }
+		auto barrier = vk::ImageMemoryBarrier2{};
+		barrier.setImage(page.texture.get_image().get().image)
+			.setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+			.setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+			.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSubresourceRange(subresource_range)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+			.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+		if (page.initialized) {
+			// existing entries may be sampled by earlier submissions.
+			barrier.setOldLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+				.setSrcStageMask(vk::PipelineStageFlagBits2::eAllGraphics)
+				.setSrcAccessMask(vk::AccessFlagBits2::eShaderSampledRead);
+		} else {
+			// texels outside entries are never sampled.
+			barrier.setOldLayout(vk::ImageLayout::eUndefined)
+				.setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+				.setSrcAccessMask(vk::AccessFlagBits2::eNone);
+		}
+		barriers.push_back(barrier);
+	}
+	auto dependency_info = vk::DependencyInfo{};
+	dependency_info.setImageMemoryBarriers(barriers);
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	for (auto& page : m_pages) {
+		if (page.regions.empty()) { continue; }
+		auto copy_info = vk::CopyBufferToImageInfo2{};
+		copy_info.setDstImage(page.texture.get_image().get().image)
+			.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSrcBuffer(staging.get().buffer)
+			.setRegions(page.regions);
+		command_buffer.copyBufferToImage2(copy_info);
+		m_stats.regions_uploaded += page.regions.size();
+		page.regions.clear();
+		page.initialized = true;
+	}
+
+	for (auto& barrier : barriers) {
+		barrier.setOldLayout(barrier.newLayout)
+			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setSrcStageMask(barrier.dstStageMask)
+			.setSrcAccessMask(barrier.dstAccessMask)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eAllGraphics)
+			.setDstAccessMask(vk::AccessFlagBits2::eShaderSampledRead);
+	}
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	m_stats.bytes_uploaded += m_pending.size();
+	m_pending.clear();
+	deferred.release(std::move(staging));
+}
+
+auto TextureAtlas::add_page() -> bool {
+	if (m_pages.size() >= m_create_info.max_pages) { return false; }
+	auto const image_ci = vma::ImageCreateInfo{
+		.allocator = m_create_info.allocator,
+		.queue_family = m_create_info.queue_family,
+	};
+	static constexpr auto usage_v = vk::ImageUsageFlagBits::eTransferDst |
+									vk::ImageUsageFlagBits::eSampled;
+	auto const size = m_create_info.page_size;
+	auto image = vma::create_image(image_ci, usage_v, m_create_info.levels,
+								   format_v, vk::Extent2D{size, size});
+	if (!image.get().image) {
+		spdlog::error("[TextureAtlas] Failed to create page Image");
+		return false;
+	}
+	auto const cells = size / m_alignment;
+	m_pages.push_back(Page{
+		.texture = Texture{m_create_info.device, std::move(image),
+						   m_create_info.sampler, m_create_info.samplers},
+		.packer = SkylinePacker{glm::uvec2{cells, cells}},
+	});
+	spdlog::info("[TextureAtlas] Page {} created ({}x{})", m_pages.size() - 1,
+				 size, size);
+	return true;
+}
+
+auto TextureAtlas::place(glm::uvec2 const cells)
+	-> std::optional<std::pair<std::uint32_t, glm::uvec2>> {
+	auto const page_cells = m_create_info.page_size / m_alignment;
+	if (cells.x > page_cells || cells.y > page_cells) { return {}; }
+	// first fit: earlier pages fill up before new ones are created.
+	for (auto index = 0uz; index < m_pages.size(); ++index) {
+		if (auto const cell = m_pages[index].packer.insert(cells)) {
+			return std::pair{static_cast<std::uint32_t>(index), *cell};
+		}
+	}
+	if (!add_page()) { return {}; }
+	auto const cell = m_pages.back().packer.insert(cells);
+	if (!cell) { return {}; }
+	return std::pair{static_cast<std::uint32_t>(m_pages.size() - 1), *cell};
+}
+
+void TextureAtlas::stage(Page& page, Bitmap const& bitmap,
+						 glm::uvec2 const texel) {
+	// the base level of the padded entry, a multiple of m_alignment.
+	auto const padded = glm::uvec2{bitmap.size} + 2u * m_gutter;
+	auto const extent =
+		(padded + m_alignment - 1u) / m_alignment * m_alignment;
+	auto const base_offset = m_pending.size();
+	auto const base_size = std::size_t{extent.x} * extent.y * channels_v;
+	m_pending.resize(base_offset + base_size);
+	auto const base = std::span{m_pending}.subspan(base_offset, base_size);
+	extrude(bitmap, base, extent, m_gutter);
+
+	auto const levels = m_create_info.levels;
+	auto const chain = build_mip_chain(
+		Bitmap{.bytes = base, .size = glm::ivec2{extent}}, levels);
+	auto const chain_offset = m_pending.size();
+	m_pending.insert(m_pending.end(), chain.bytes.begin(), chain.bytes.end());
+
+	for (auto level = 0u; level < levels; ++level) {
+		auto const offset =
+			level == 0 ? base_offset : chain_offset + chain.offsets[level - 1];
+		auto subresource = vk::ImageSubresourceLayers{};
+		subresource.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setMipLevel(level)
+			.setLayerCount(1);
+		auto const position = texel >> level;
+		auto const size = extent >> level;
+		auto region = vk::BufferImageCopy2{};
+		region.setBufferOffset(offset)
+			.setImageSubresource(subresource)
+			.setImageOffset({static_cast<std::int32_t>(position.x),
+							 static_cast<std::int32_t>(position.y), 0})
+			.setImageExtent({size.x, size.y, 1});
+		page.regions.push_back(region);
+	}
+}
+} // namespace lvk
@@ -0,0 +1,112 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <skyline_packer.hpp>
+#include <texture.hpp>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace lvk {
+struct TextureAtlasCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	std::uint32_t queue_family;
+
+	// width and height of each page, a multiple of 2^(levels - 1).
+	std::uint32_t page_size{2048};
+	std::uint32_t max_pages{4};
+	// mip levels of each page (including the base).
+	std::uint32_t levels{4};
+	// texels of extruded border around each entry at the smallest level.
+	std::uint32_t padding{1};
+
+	vk::SamplerCreateInfo sampler{sampler_ci_v};
+	// optional, creates a dedicated sampler per page if null.
+	SamplerCache* samplers{};
+};
+
+// Where an inserted Bitmap lives: normalized coordinates of its texels
+// within a page, for per-instance UV offset / scale.
+struct AtlasEntry {
+	std::uint32_t page{};
+	glm::vec2 uv_min{};
+	glm::vec2 uv_max{};
+};
+
+struct TextureAtlasStats {
+	std::uint64_t insertions{};
+	// Bitmaps that did not fit in any page.
+	std::uint64_t rejections{};
+	std::uint64_t regions_uploaded{};
+	std::uint64_t bytes_uploaded{};
+};
+
+// Packs many small RGBA8 Bitmaps into a few large sampled pages (skyline
+// bottom-left). Each entry is surrounded by a gutter of its extruded edges,
+// and placed at a multiple of 2^(levels - 1): every mip level of an entry
+// is built from its own texels only, and linear filtering never bleeds in
+// a neighbour. Insertions are CPU side, record() uploads the dirty
+// rectangles of each page as one copy with a region per entry and level.
+class TextureAtlas {
+  public:
+	using CreateInfo = TextureAtlasCreateInfo;
+
+	explicit TextureAtlas(CreateInfo const& create_info);
+
+	// returns nullopt if bitmap is empty or does not fit in any page.
+	// the entry can be sampled once the next record() has executed.
+	[[nodiscard]] auto insert(Bitmap const& bitmap)
+		-> std::optional<AtlasEntry>;
+
+	[[nodiscard]] auto has_pending() const -> bool {
+		return !m_pending.empty();
+	}
+	// uploads all pending insertions, leaving pages in
+	// ShaderReadOnlyOptimal. Must be recorded on a graphics queue outside
+	// rendering; the staging Buffer is released into deferred.
+	void record(vk::CommandBuffer command_buffer, DeferredQueue& deferred);
+
+	[[nodiscard]] auto get_page_count() const -> std::uint32_t {
+		return static_cast<std::uint32_t>(m_pages.size());
+	}
+	[[nodiscard]] auto get_page(std::uint32_t index) const -> Texture const& {
+		return m_pages.at(index).texture;
+	}
+	// packed area / page area, gutters included.
+	[[nodiscard]] auto get_occupancy(std::uint32_t index) const -> float {
+		return m_pages.at(index).packer.get_occupancy();
+	}
+
+	[[nodiscard]] auto get_stats() const -> TextureAtlasStats {
+		return m_stats;
+	}
+
+  private:
+	struct Page {
+		Texture texture;
+		// in units of m_alignment texels.
+		SkylinePacker packer;
+		// dirty rectangles since the last record().
+		std::vector<vk::BufferImageCopy2> regions{};
+		// in ShaderReadOnlyOptimal, after its first upload.
+		bool initialized{};
+	};
+
+	[[nodiscard]] auto add_page() -> bool;
+	[[nodiscard]] auto place(glm::uvec2 cells)
+		-> std::optional<std::pair<std::uint32_t, glm::uvec2>>;
+	void stage(Page& page, Bitmap const& bitmap, glm::uvec2 texel);
+
+	CreateInfo m_create_info{};
+	// texels per packer cell: 2^(levels - 1).
+	std::uint32_t m_alignment{};
+	// extruded texels on each side of an entry at the base level.
+	std::uint32_t m_gutter{};
+
+	std::vector<Page> m_pages{};
+	// texels of all dirty regions, referenced by their buffer offsets.
+	std::vector<std::byte> m_pending{};
+	TextureAtlasStats m_stats{};
+};
+} // namespace lvk
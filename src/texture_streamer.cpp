@@ -0,0 +1,277 @@
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+#include <texture_streamer.hpp>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+[[nodiscard]] constexpr auto to_mib(std::size_t const bytes) -> double {
+	return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+} // namespace
+
+TextureStreamer::TextureStreamer(CreateInfo const& create_info)
+	: m_create_info(create_info) {
+	if (!m_create_info.bindless) {
+		// one set per texture, plus the fallback's.
+		auto const max_sets = m_create_info.max_textures + 1;
+		auto const pool_sizes = std::array{
+			vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler,
+								   max_sets},
+		};
+		auto pool_ci = vk::DescriptorPoolCreateInfo{};
+		pool_ci.setPoolSizes(pool_sizes).setMaxSets(max_sets);
+		m_descriptor_pool =
+			m_create_info.device.createDescriptorPoolUnique(pool_ci);
+	}
+
+	if (m_create_info.compression) {
+		auto const physical_device =
+			vma::get_physical_device(m_create_info.uploader->get_allocator());
+		m_opaque_format = select_block_format(physical_device, true);
+		m_alpha_format = select_block_format(physical_device, false);
+	}
+
+	// not waited on: the first frame's submission waits for it on the GPU.
+	auto batch = m_create_info.uploader->begin_batch();
+	m_fallback.emplace(m_create_info.device, batch.add_image(white_bitmap_v),
+					   m_create_info.sampler, m_create_info.samplers);
+	m_create_info.uploader->submit(std::move(batch));
+	if (m_create_info.bindless) {
+		auto const index =
+			m_create_info.bindless->add(m_fallback->descriptor_info());
+		if (!index) {
+			throw std::runtime_error{"Out of bindless texture slots"};
+		}
+		m_fallback_index = *index;
+	} else {
+		m_fallback_set = allocate_set(*m_fallback);
+	}
+}
+
+TextureStreamer::~TextureStreamer() {
+	m_create_info.jobs->wait(m_decode_jobs);
+}
+
+auto TextureStreamer::request(fs::path path, float const priority)
+	-> TextureHandle {
+	auto const ret =
+		TextureHandle{.index = static_cast<std::uint32_t>(m_slots.size())};
+	auto slot = Slot{
+		.path = std::move(path),
+		.priority = priority,
+		.set = m_fallback_set,
+		.index = m_fallback_index,
+	};
+	if (m_slots.size() >= m_create_info.max_textures) {
+		spdlog::error("[TextureStreamer] Out of textures ({}): '{}'",
+					  m_create_info.max_textures, slot.path.generic_string());
+		slot.state = State::Failed;
+	} else {
+		m_pending.push_back(ret.index);
+		m_pending_dirty = true;
+	}
+	m_slots.push_back(std::move(slot));
+	return ret;
+}
+
+void TextureStreamer::set_priority(TextureHandle const handle,
+								   float const priority) {
+	auto& slot = m_slots.at(handle.index);
+	if (slot.state != State::Pending || slot.priority == priority) { return; }
+	slot.priority = priority;
+	m_pending_dirty = true;
+}
+
+void TextureStreamer::update() {
+	switch_completed();
+	upload_decoded();
+	start_decodes();
+}
+
+auto TextureStreamer::get_set(TextureHandle const handle) const
+	-> vk::DescriptorSet {
+	return m_slots.at(handle.index).set;
+}
+
+auto TextureStreamer::get_index(TextureHandle const handle) const
+	-> std::uint32_t {
+	return m_slots.at(handle.index).index;
+}
+
+auto TextureStreamer::is_resident(TextureHandle const handle) const -> bool {
+	return m_slots.at(handle.index).state == State::Resident;
+}
+
+auto TextureStreamer::get_stats() const -> TextureStreamerStats {
+	auto ret = TextureStreamerStats{
+		.pending = m_pending.size(),
+		.decoding = m_decoding,
+		.uploading = m_uploading.size(),
+		.bytes_in_flight = m_bytes_in_flight,
+	};
+	for (auto const& slot : m_slots) {
+		if (slot.state == State::Resident) { ++ret.resident; }
+		if (slot.state == State::Failed) { ++ret.failed; }
+	}
+	return ret;
+}
+
+void TextureStreamer::inspect() const {
+	auto const stats = get_stats();
+	ImGui::Text("pending: %zu, decoding: %zu, uploading: %zu", stats.pending,
+				stats.decoding, stats.uploading);
+	ImGui::Text("resident: %zu, failed: %zu", stats.resident, stats.failed);
+	ImGui::Text("in flight: %.2f / %.2f MiB", to_mib(stats.bytes_in_flight),
+				to_mib(m_create_info.max_bytes_in_flight));
+}
+
+void TextureStreamer::switch_completed() {
+	// uploads submitted by earlier calls have been acquired by earlier
+	// frames: safe to sample once complete.
+	std::erase_if(m_uploading, [this](std::uint32_t const index) {
+		auto& slot = m_slots[index];
+		if (!m_create_info.uploader->is_complete(slot.ticket)) {
+			return false;
+		}
+		slot.state = bind(slot) ? State::Resident : State::Failed;
+		m_bytes_in_flight -= slot.bytes;
+		return true;
+	});
+}
+
+void TextureStreamer::upload_decoded() {
+	auto decoded = std::vector<Decoded>{};
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		std::swap(decoded, m_decoded);
+	}
+	if (decoded.empty()) { return; }
+	m_decoding -= decoded.size();
+
+	auto batch = m_create_info.uploader->begin_batch();
+	auto const first_uploading = m_uploading.size();
+	for (auto const& [index, image, encoded] : decoded) {
+		auto& slot = m_slots[index];
+		// encoded textures are only copied here.
+		auto vma_image =
+			image.get().pixels == nullptr
+				? vma::Image{}
+				: (encoded ? batch.add_image(*encoded)
+						   : batch.add_image(image.get().bitmap(),
+											 m_create_info.mips));
+		if (!vma_image.get().image) {
+			// failed to load (or to stage), stays on the fallback.
+			slot.state = State::Failed;
+			continue;
+		}
+		slot.texture.emplace(m_create_info.device, std::move(vma_image),
+							 m_create_info.sampler, m_create_info.samplers);
+		slot.state = State::Uploading;
+		slot.bytes = image.get().bitmap().bytes.size();
+		m_bytes_in_flight += slot.bytes;
+		m_uploading.push_back(index);
+	}
+	if (batch.is_empty()) { return; }
+
+	// pixels have been staged, decoded images are freed on return.
+	auto const ticket = m_create_info.uploader->submit(std::move(batch));
+	for (auto i = first_uploading; i < m_uploading.size(); ++i) {
+		m_slots[m_uploading[i]].ticket = ticket;
+	}
+}
+
+void TextureStreamer::start_decodes() {
+	if (m_pending_dirty) {
+		// highest priority at the back, earliest request first among equal
+		// priorities.
+		std::ranges::sort(m_pending, [this](std::uint32_t const a,
+											std::uint32_t const b) {
+			auto const lhs = m_slots[a].priority;
+			auto const rhs = m_slots[b].priority;
+			return lhs < rhs || (lhs == rhs && a > b);
+		});
+		m_pending_dirty = false;
+	}
+
+	// one file per thread at a time, decoded images count towards the
+	// budget once collected: it may be overshot by up to this many files.
+	auto const max_decoding = m_create_info.jobs->get_worker_count() + 1;
+	while (!m_pending.empty() && m_decoding < max_decoding) {
+		// always make progress, even if a single file exceeds the budget.
+		auto const idle = m_decoding == 0 && m_bytes_in_flight == 0;
+		if (!idle && m_bytes_in_flight >= m_create_info.max_bytes_in_flight) {
+			break;
+		}
+		auto const index = m_pending.back();
+		m_pending.pop_back();
+		auto& slot = m_slots[index];
+		slot.state = State::Decoding;
+		++m_decoding;
+		m_create_info.jobs->submit(
+			[this, index, path = slot.path] {
+				auto image = load_image(path);
+				auto encoded = encode(image);
+				auto lock = std::scoped_lock{m_mutex};
+				m_decoded.push_back(Decoded{
+					.index = index,
+					.image = std::move(image),
+					.encoded = std::move(encoded),
+				});
+			},
+			&m_decode_jobs);
+	}
+}
+
+auto TextureStreamer::encode(ImageFile const& image) const
+	-> std::optional<EncodedImage> {
+	if (!m_create_info.compression || image.get().pixels == nullptr) {
+		return {};
+	}
+	auto const bitmap = image.get().bitmap();
+	auto const format = is_opaque(bitmap) ? m_opaque_format : m_alpha_format;
+	// uploaded as RGBA8 if the GPU supports no block format.
+	if (!format) { return {}; }
+	auto const usize = glm::uvec2{bitmap.size};
+	auto const levels =
+		get_mip_levels(vk::Extent2D{usize.x, usize.y}, m_create_info.mips);
+	return encode_image(bitmap, *format, levels, *m_create_info.compression);
+}
+
+auto TextureStreamer::bind(Slot& out_slot) const -> bool {
+	// a new set / slot: the fallback's may be in use by frames in flight.
+	if (!m_create_info.bindless) {
+		out_slot.set = allocate_set(*out_slot.texture);
+		return true;
+	}
+	auto const index =
+		m_create_info.bindless->add(out_slot.texture->descriptor_info());
+	if (!index) {
+		spdlog::error("[TextureStreamer] Out of bindless texture slots: '{}'",
+					  out_slot.path.generic_string());
+		return false;
+	}
+	out_slot.index = *index;
+	return true;
+}
+
+auto TextureStreamer::allocate_set(Texture const& texture) const
+	-> vk::DescriptorSet {
+	auto allocate_info = vk::DescriptorSetAllocateInfo{};
+	allocate_info.setDescriptorPool(*m_descriptor_pool)
+		.setSetLayouts(m_create_info.set_layout);
+	auto const ret =
+		m_create_info.device.allocateDescriptorSets(allocate_info).front();
+	auto const image_info = texture.descriptor_info();
+	auto write = vk::WriteDescriptorSet{};
+	write.setImageInfo(image_info)
+		.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+		.setDescriptorCount(1)
+		.setDstSet(ret)
+		.setDstBinding(0);
+	m_create_info.device.updateDescriptorSets(write, {});
+	return ret;
+}
+} // namespace lvk
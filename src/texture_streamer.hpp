@@ -0,0 +1,170 @@
+#pragma once
+#include <async_uploader.hpp>
+#include <bindless_textures.hpp>
+#include <image_file.hpp>
+#include <job_system.hpp>
+#include <texture.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace lvk {
+namespace fs = std::filesystem;
+
+// Index of a texture requested from a TextureStreamer.
+struct TextureHandle {
+	std::uint32_t index{};
+
+	auto operator<=>(TextureHandle const&) const = default;
+};
+
+struct TextureStreamerCreateInfo {
+	vk::Device device;
+	AsyncUploader* uploader;
+	JobSystem* jobs;
+	// layout of each texture's set: a combined image sampler at binding 0.
+	vk::DescriptorSetLayout set_layout;
+	// optional, textures are added to it instead of being given their own
+	// sets (set_layout is then unused).
+	BindlessTextures* bindless{};
+	// decoded bytes not yet resident on the GPU, no more files are decoded
+	// beyond this. should be well below the uploader's staging capacity, so
+	// that uploads do not wait for the GPU.
+	std::size_t max_bytes_in_flight{StagingRing::default_capacity_v / 2};
+	// number of handles that can be requested.
+	std::uint32_t max_textures{256};
+	MipSettings mips{};
+	// optional, encodes textures into a block compressed format in their
+	// decode jobs, update() only copies the blocks: set jobs to also split
+	// each texture across threads.
+	std::optional<BlockEncodeSettings> compression{};
+
+	vk::SamplerCreateInfo sampler{sampler_ci_v};
+	// optional, every texture creates its own sampler if null.
+	SamplerCache* samplers{};
+};
+
+struct TextureStreamerStats {
+	// requests waiting to be decoded.
+	std::size_t pending{};
+	// files being decoded.
+	std::size_t decoding{};
+	// uploads waiting for the GPU.
+	std::size_t uploading{};
+	std::size_t resident{};
+	// files that failed to load, their handles stay bound to the fallback.
+	std::size_t failed{};
+	std::size_t bytes_in_flight{};
+};
+
+// Streams image files (PNG / JPEG) in without blocking: request() returns a
+// handle bound to a white fallback texture, files are decoded on the
+// JobSystem in priority order, uploaded through the AsyncUploader, and each
+// handle is switched to a new descriptor set (or bindless slot) with the real
+// image once its upload has completed on the GPU. Sets and slots are never
+// updated once written, so frames in flight keep using the fallback.
+// Not thread-safe: called on the render thread only.
+class TextureStreamer {
+  public:
+	using CreateInfo = TextureStreamerCreateInfo;
+
+	explicit TextureStreamer(CreateInfo const& create_info);
+
+	TextureStreamer(TextureStreamer const&) = delete;
+	TextureStreamer(TextureStreamer&&) = delete;
+	auto operator=(TextureStreamer const&) = delete;
+	auto operator=(TextureStreamer&&) = delete;
+
+	// waits for decode jobs in flight.
+	~TextureStreamer();
+
+	// requests with higher priority are decoded first. if max_textures have
+	// already been requested, the returned handle stays on the fallback.
+	[[nodiscard]] auto request(fs::path path, float priority = 0.0f)
+		-> TextureHandle;
+	// reprioritizes a request that has not started decoding yet.
+	void set_priority(TextureHandle handle, float priority);
+
+	// switches handles whose uploads have completed, uploads decoded files
+	// in one batch, and starts decoding pending requests within the byte
+	// budget. call once per frame, before AsyncUploader::record_acquires():
+	// uploads submitted here are acquired by the same frame.
+	void update();
+
+	// set of handle's texture, or of the fallback until it is resident.
+	[[nodiscard]] auto get_set(TextureHandle handle) const
+		-> vk::DescriptorSet;
+	// bindless slot of handle's texture, or of the fallback, as above.
+	[[nodiscard]] auto get_index(TextureHandle handle) const -> std::uint32_t;
+	[[nodiscard]] auto is_resident(TextureHandle handle) const -> bool;
+
+	[[nodiscard]] auto get_stats() const -> TextureStreamerStats;
+	void inspect() const;
+
+  private:
+	enum class State : std::int8_t {
+		Pending,
+		Decoding,
+		Uploading,
+		Resident,
+		Failed,
+	};
+
+	struct Slot {
+		fs::path path{};
+		float priority{};
+		State state{};
+		std::optional<Texture> texture{};
+		// the fallback's set / bindless slot until resident.
+		vk::DescriptorSet set{};
+		std::uint32_t index{};
+		UploadTicket ticket{};
+		// decoded size, counted in m_bytes_in_flight until resident.
+		std::size_t bytes{};
+	};
+
+	struct Decoded {
+		std::uint32_t index{};
+		ImageFile image{};
+		// set if compression is enabled and the GPU has a block format.
+		std::optional<EncodedImage> encoded{};
+	};
+
+	void switch_completed();
+	void upload_decoded();
+	void start_decodes();
+	// called by decode jobs.
+	[[nodiscard]] auto encode(ImageFile const& image) const
+		-> std::optional<EncodedImage>;
+	// writes texture into a new set or bindless slot.
+	[[nodiscard]] auto bind(Slot& out_slot) const -> bool;
+	[[nodiscard]] auto allocate_set(Texture const& texture) const
+		-> vk::DescriptorSet;
+
+	CreateInfo m_create_info{};
+	vk::UniqueDescriptorPool m_descriptor_pool{};
+	std::optional<Texture> m_fallback{};
+	vk::DescriptorSet m_fallback_set{};
+	std::uint32_t m_fallback_index{};
+	// selected once if compression is set: for opaque / other textures.
+	std::optional<BlockFormat> m_opaque_format{};
+	std::optional<BlockFormat> m_alpha_format{};
+
+	std::vector<Slot> m_slots{};
+	// indices of Pending slots, sorted by ascending priority when dirty.
+	std::vector<std::uint32_t> m_pending{};
+	bool m_pending_dirty{};
+	// indices of Uploading slots.
+	std::vector<std::uint32_t> m_uploading{};
+	std::size_t m_decoding{};
+	std::size_t m_bytes_in_flight{};
+
+	// written by decode jobs, collected by update().
+	std::mutex m_mutex{};
+	std::vector<Decoded> m_decoded{};
+	// decode jobs in flight, waited for on destruction.
+	JobCounter m_decode_jobs{};
+};
+} // namespace lvk
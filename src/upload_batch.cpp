@@ -0,0 +1,245 @@
+#include <async_uploader.hpp>
+#include <upload_batch.hpp>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <ranges>
+
+namespace lvk {
+auto UploadBatch::add_buffer(vk::BufferUsageFlags const usage,
+							 vma::ByteSpans const& byte_spans) -> vma::Buffer {
+	auto const total_size = std::accumulate(
+		byte_spans.begin(), byte_spans.end(), 0uz,
+		[](std::size_t const n, std::span<std::byte const> bytes) {
+			return n + bytes.size();
+		});
+
+	auto const& uploader_ci = m_uploader->m_create_info;
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = uploader_ci.allocator,
+		.usage = usage,
+		.queue_family = uploader_ci.queue_family,
+	};
+	auto ret = vma::create_buffer(buffer_ci, vma::BufferMemoryType::Device,
+								  total_size);
+	if (!ret.get().buffer) { return {}; }
+	auto const src = stage(byte_spans);
+	if (!src.buffer) { return {}; }
+
+	m_buffer_copies.push_back(BufferCopy{.src = src, .dst = ret.get().buffer});
+	return ret;
+}
+
+auto UploadBatch::write_buffer(vk::Buffer const dst,
+							   vk::DeviceSize const offset,
+							   vma::ByteSpans const& byte_spans) -> bool {
+	auto const src = stage(byte_spans);
+	if (!src.buffer) { return false; }
+	m_buffer_copies.push_back(
+		BufferCopy{.src = src, .dst = dst, .dst_offset = offset});
+	return true;
+}
+
+auto UploadBatch::write_buffers(std::span<BufferWrite const> const writes)
+	-> bool {
+	auto byte_spans = std::vector<std::span<std::byte const>>{};
+	byte_spans.reserve(writes.size());
+	for (auto const& write : writes) { byte_spans.push_back(write.bytes); }
+	auto const src = stage(byte_spans);
+	if (!src.buffer) { return false; }
+
+	// each write copies its own sub-range of the staged bytes.
+	auto offset = 0uz;
+	for (auto const& write : writes) {
+		auto const size = write.bytes.size();
+		auto const write_src = StagingSlice{
+			.buffer = src.buffer,
+			.offset = src.offset + offset,
+			.bytes = src.bytes.subspan(offset, size),
+		};
+		m_buffer_copies.push_back(BufferCopy{
+			.src = write_src,
+			.dst = write.dst,
+			.dst_offset = write.offset,
+		});
+		offset += size;
+	}
+	return true;
+}
+
+auto UploadBatch::add_image(
+	Bitmap const& bitmap, MipSettings const& mips,
+	std::optional<BlockEncodeSettings> const& compression) -> vma::Image {
+	auto const usize = glm::uvec2{bitmap.size};
+	auto const extent = vk::Extent2D{usize.x, usize.y};
+	auto const& uploader_ci = m_uploader->m_create_info;
+	auto const levels = get_mip_levels(extent, mips);
+	if (compression) {
+		auto const block_format = select_block_format(
+			vma::get_physical_device(uploader_ci.allocator),
+			is_opaque(bitmap));
+		if (block_format) {
+			return add_image(
+				encode_image(bitmap, *block_format, levels, *compression));
+		}
+	}
+
+	auto const image_ci = vma::ImageCreateInfo{
+		.allocator = uploader_ci.allocator,
+		.queue_family = uploader_ci.queue_family,
+	};
+	auto const format = vk::Format::eR8G8B8A8Srgb;
+	auto const blit = levels > 1 && m_uploader->supports_blit(format);
+	auto const chain = blit ? MipChain{} : build_mip_chain(bitmap, levels);
+	// TransferSrc: levels are blitted from, and the image can be moved by
+	// copying.
+	auto const usage = vk::ImageUsageFlagBits::eTransferDst |
+					   vk::ImageUsageFlagBits::eTransferSrc |
+					   vk::ImageUsageFlagBits::eSampled;
+	auto ret = vma::create_image(image_ci, usage, levels, format, extent);
+	if (!ret.get().image) { return {}; }
+
+	// bytes of each level, tightly packed in staging.
+	auto const byte_spans = std::array<std::span<std::byte const>, 2>{
+		bitmap.bytes, chain.bytes};
+	auto level_offsets = std::vector<vk::DeviceSize>{0};
+	auto const base_size = bitmap.bytes.size_bytes();
+	for (auto const offset : chain.offsets) {
+		level_offsets.push_back(base_size + offset);
+	}
+	auto const src = stage(byte_spans);
+	if (!src.buffer) { return {}; }
+
+	auto copy = ImageCopy{
+		.src = src,
+		.dst = ret.get().image,
+		.extent = extent,
+		.levels = levels,
+		.blit = blit,
+	};
+	add_level_regions(copy, level_offsets);
+	m_image_copies.push_back(std::move(copy));
+	return ret;
+}
+
+auto UploadBatch::add_image(EncodedImage const& encoded) -> vma::Image {
+	auto const& uploader_ci = m_uploader->m_create_info;
+	auto const image_ci = vma::ImageCreateInfo{
+		.allocator = uploader_ci.allocator,
+		.queue_family = uploader_ci.queue_family,
+	};
+	auto const levels = static_cast<std::uint32_t>(encoded.levels.size());
+	// TransferSrc: the image can be moved by copying.
+	auto const usage = vk::ImageUsageFlagBits::eTransferDst |
+					   vk::ImageUsageFlagBits::eTransferSrc |
+					   vk::ImageUsageFlagBits::eSampled;
+	auto ret = vma::create_image(image_ci, usage, levels,
+								 to_vk_format(encoded.format), encoded.extent);
+	if (!ret.get().image) { return {}; }
+
+	// blocks of each level, tightly packed in staging.
+	auto byte_spans = std::vector<std::span<std::byte const>>{};
+	auto level_offsets = std::vector<vk::DeviceSize>{};
+	auto offset = vk::DeviceSize{};
+	for (auto const& blocks : encoded.levels) {
+		byte_spans.emplace_back(blocks);
+		level_offsets.push_back(offset);
+		offset += blocks.size();
+	}
+	auto const src = stage(byte_spans);
+	if (!src.buffer) { return {}; }
+
+	// blocks cannot be blitted into.
+	auto copy = ImageCopy{
+		.src = src,
+		.dst = ret.get().image,
+		.extent = encoded.extent,
+		.levels = levels,
+	};
+	add_level_regions(copy, level_offsets);
+	m_image_copies.push_back(std::move(copy));
+	return ret;
+}
+
+auto UploadBatch::add_image(Ktx2 const& ktx2) -> vma::Image {
+	auto const& uploader_ci = m_uploader->m_create_info;
+	auto const image_ci = vma::ImageCreateInfo{
+		.allocator = uploader_ci.allocator,
+		.queue_family = uploader_ci.queue_family,
+	};
+	auto const levels = ktx2.get_levels();
+	auto const level_count = static_cast<std::uint32_t>(levels.size());
+	// TransferSrc: the image can be moved by copying.
+	auto const usage = vk::ImageUsageFlagBits::eTransferDst |
+					   vk::ImageUsageFlagBits::eTransferSrc |
+					   vk::ImageUsageFlagBits::eSampled;
+	auto ret =
+		vma::create_image(image_ci, usage, level_count, ktx2.get_format(),
+						  ktx2.get_extent(), ktx2.get_layers());
+	if (!ret.get().image) { return {}; }
+	auto const byte_spans = std::array{ktx2.get_payload()};
+	auto const src = stage(byte_spans);
+	if (!src.buffer) { return {}; }
+
+	auto copy = ImageCopy{
+		.src = src,
+		.dst = ret.get().image,
+		.extent = ktx2.get_extent(),
+		.levels = level_count,
+		.layers = ktx2.get_layers(),
+	};
+	auto subresource_layers = vk::ImageSubresourceLayers{};
+	subresource_layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(ktx2.get_layers());
+	// layers of a level are tightly packed.
+	for (auto const [index, level] : std::views::enumerate(levels)) {
+		subresource_layers.setMipLevel(static_cast<std::uint32_t>(index));
+		auto region = vk::BufferImageCopy2{};
+		region.setBufferOffset(src.offset + level.offset)
+			.setImageSubresource(subresource_layers)
+			.setImageExtent(
+				vk::Extent3D{level.extent.width, level.extent.height, 1});
+		copy.regions.push_back(region);
+	}
+	m_image_copies.push_back(std::move(copy));
+	return ret;
+}
+
+void UploadBatch::add_level_regions(
+	ImageCopy& out_copy, std::span<vk::DeviceSize const> level_offsets) {
+	auto subresource_layers = vk::ImageSubresourceLayers{};
+	subresource_layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(1);
+	for (auto const [index, offset] : std::views::enumerate(level_offsets)) {
+		auto const level = static_cast<std::uint32_t>(index);
+		auto const level_extent = get_mip_extent(out_copy.extent, level);
+		subresource_layers.setMipLevel(level);
+		auto region = vk::BufferImageCopy2{};
+		region.setBufferOffset(out_copy.src.offset + offset)
+			.setImageSubresource(subresource_layers)
+			.setImageExtent(
+				vk::Extent3D{level_extent.width, level_extent.height, 1});
+		out_copy.regions.push_back(region);
+	}
+}
+
+auto UploadBatch::stage(vma::ByteSpans const& byte_spans) -> StagingSlice {
+	auto const total_size = std::accumulate(
+		byte_spans.begin(), byte_spans.end(), 0uz,
+		[](std::size_t const n, std::span<std::byte const> bytes) {
+			return n + bytes.size();
+		});
+	auto staging = m_uploader->stage(total_size);
+	if (!staging.slice.buffer) { return {}; }
+
+	auto dst = staging.slice.bytes;
+	for (auto const bytes : byte_spans) {
+		std::memcpy(dst.data(), bytes.data(), bytes.size());
+		dst = dst.subspan(bytes.size());
+	}
+	if (staging.dedicated.get().buffer) {
+		m_dedicated.push_back(std::move(staging.dedicated));
+	}
+	return staging.slice;
+}
+} // namespace lvk
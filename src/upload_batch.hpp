@@ -0,0 +1,104 @@
+#pragma once
+#include <block_encoder.hpp>
+#include <ktx2.hpp>
+#include <staging_ring.hpp>
+#include <vma.hpp>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lvk {
+class AsyncUploader;
+
+// bytes written into dst at offset by UploadBatch::write_buffers().
+struct BufferWrite {
+	vk::Buffer dst{};
+	vk::DeviceSize offset{};
+	std::span<std::byte const> bytes{};
+};
+
+// Collects buffer and image uploads to be recorded into one Command Buffer
+// and submitted once by AsyncUploader::submit(): layout transitions and
+// ownership transfers of all images / buffers are merged into a single
+// pipelineBarrier2 call before and after the copies.
+// Obtained from AsyncUploader::begin_batch().
+class UploadBatch {
+  public:
+	// returns a Device Buffer with each byte span sequentially written,
+	// usable on the GPU once the batch's ticket is signalled.
+	[[nodiscard]] auto add_buffer(vk::BufferUsageFlags usage,
+								  vma::ByteSpans const& byte_spans)
+		-> vma::Buffer;
+	// writes each byte span sequentially into dst at offset, visible on the
+	// GPU once the batch's ticket is signalled. dst must support TransferDst,
+	// and the range must not be in use by the GPU.
+	// returns false if staging memory could not be allocated.
+	auto write_buffer(vk::Buffer dst, vk::DeviceSize offset,
+					  vma::ByteSpans const& byte_spans) -> bool;
+	// performs each write as above, staged together: either all of them are
+	// queued, or none (returns false) if staging memory could not be
+	// allocated.
+	auto write_buffers(std::span<BufferWrite const> writes) -> bool;
+	// returns a sampled image in ShaderReadOnlyOptimal layout, usable on the
+	// GPU once the batch's ticket is signalled.
+	// mip levels are blitted on the graphics queue if the format supports it
+	// (after ownership is acquired, when uploading on a transfer queue), else
+	// built on the CPU and copied with the base level.
+	// if compression is set, all levels are built on the CPU and encoded
+	// into the best block format the GPU supports (select_block_format()),
+	// falling back to RGBA8 if there is none, before this returns.
+	[[nodiscard]] auto
+	add_image(Bitmap const& bitmap, MipSettings const& mips = {},
+			  std::optional<BlockEncodeSettings> const& compression = {})
+		-> vma::Image;
+	// returns a sampled image with all levels of encoded, as above: only
+	// copies the blocks, which can be encoded off the calling thread.
+	// encoded's format must be supported by the GPU.
+	[[nodiscard]] auto add_image(EncodedImage const& encoded) -> vma::Image;
+	// returns a sampled image with all levels and layers of ktx2, as above.
+	// the payload is staged straight from the file mapping, and all levels
+	// are copied with one region each.
+	// ktx2's format and layer count must be supported by the GPU (see
+	// Ktx2::select()).
+	[[nodiscard]] auto add_image(Ktx2 const& ktx2) -> vma::Image;
+
+	[[nodiscard]] auto is_empty() const -> bool {
+		return m_buffer_copies.empty() && m_image_copies.empty();
+	}
+
+  private:
+	struct BufferCopy {
+		StagingSlice src{};
+		vk::Buffer dst{};
+		vk::DeviceSize dst_offset{};
+	};
+
+	struct ImageCopy {
+		StagingSlice src{};
+		vk::Image dst{};
+		vk::Extent2D extent{};
+		std::uint32_t levels{1};
+		std::uint32_t layers{1};
+		// one region per level in src, absolute buffer offsets.
+		std::vector<vk::BufferImageCopy2> regions{};
+		// levels below the base level are to be blitted.
+		bool blit{};
+	};
+
+	explicit UploadBatch(AsyncUploader& uploader) : m_uploader(&uploader) {}
+
+	auto stage(vma::ByteSpans const& byte_spans) -> StagingSlice;
+	// one region per level of a single layer, at level_offsets from src.
+	static void
+	add_level_regions(ImageCopy& out_copy,
+					  std::span<vk::DeviceSize const> level_offsets);
+
+	AsyncUploader* m_uploader{};
+	std::vector<BufferCopy> m_buffer_copies{};
+	std::vector<ImageCopy> m_image_copies{};
+	// dedicated staging Buffers, kept alive until the copies complete.
+	std::vector<vma::Buffer> m_dedicated{};
+
+	friend class AsyncUploader;
+};
+} // namespace lvk
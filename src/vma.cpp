@@ -1,6 +1,8 @@
 #include <spdlog/spdlog.h>
 #include <vma.hpp>
-#include <numeric>
+#include <algorithm>
+#include <atomic>
+#include <ranges>
 #include <stdexcept>
 
 namespace lvk {
@@ -9,19 +11,61 @@ void Deleter::operator()(VmaAllocator allocator) const noexcept {
 	vmaDestroyAllocator(allocator);
 }
 
+namespace {
+struct AtomicCount {
+	std::atomic<std::uint64_t> created{};
+	std::atomic<std::uint64_t> live{};
+};
+
+// indexed by AllocationCategory.
+std::array<AtomicCount, allocation_category_count_v> g_counts{};
+
+void on_created(AllocationCategory const category) {
+	auto& count = g_counts.at(static_cast<std::size_t>(category));
+	++count.created;
+	++count.live;
+}
+
+void on_destroyed(AllocationCategory const category) {
+	--g_counts.at(static_cast<std::size_t>(category)).live;
+}
+} // namespace
+
 void BufferDeleter::operator()(RawBuffer const& raw_buffer) const noexcept {
 	vmaDestroyBuffer(raw_buffer.allocator, raw_buffer.buffer,
 					 raw_buffer.allocation);
+	on_destroyed(raw_buffer.category);
 }
 
 void ImageDeleter::operator()(RawImage const& raw_image) const noexcept {
 	vmaDestroyImage(raw_image.allocator, raw_image.image, raw_image.allocation);
+	on_destroyed(AllocationCategory::Image);
 }
+
+namespace {
+// legacy PCIe BAR window: heaps this small are not used for DeviceHost.
+constexpr vk::DeviceSize bar_window_v{256 * 1024 * 1024};
+
+[[nodiscard]] auto has_device_host_heap(VmaAllocator allocator) -> bool {
+	static constexpr auto flags_v = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+									VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+	VkPhysicalDeviceMemoryProperties const* properties{};
+	vmaGetMemoryProperties(allocator, &properties);
+	auto const types = std::span{properties->memoryTypes}.first(
+		properties->memoryTypeCount);
+	return std::ranges::any_of(types, [properties](VkMemoryType const& type) {
+		if ((type.propertyFlags & flags_v) != flags_v) { return false; }
+		return properties->memoryHeaps[type.heapIndex].size > bar_window_v;
+	});
+}
+
+} // namespace
 } // namespace vma
 
 auto vma::create_allocator(vk::Instance const instance,
 						   vk::PhysicalDevice const physical_device,
-						   vk::Device const device) -> Allocator {
+						   vk::Device const device,
+						   bool const memory_budget) -> Allocator {
 	auto const& dispatcher = VULKAN_HPP_DEFAULT_DISPATCHER;
 	// need to zero initialize C structs, unlike VulkanHPP.
 	auto vma_vk_funcs = VmaVulkanFunctions{};
@@ -33,6 +77,9 @@ auto vma::create_allocator(vk::Instance const instance,
 	allocator_ci.device = device;
 	allocator_ci.pVulkanFunctions = &vma_vk_funcs;
 	allocator_ci.instance = instance;
+	if (memory_budget) {
+		allocator_ci.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+	}
 	VmaAllocator ret{};
 	auto const result = vmaCreateAllocator(&allocator_ci, &ret);
 	if (result == VK_SUCCESS) { return ret; }
@@ -40,6 +87,21 @@ auto vma::create_allocator(vk::Instance const instance,
 	throw std::runtime_error{"Failed to create Vulkan Memory Allocator"};
 }
 
+auto vma::get_physical_device(VmaAllocator allocator) -> vk::PhysicalDevice {
+	auto allocator_info = VmaAllocatorInfo{};
+	vmaGetAllocatorInfo(allocator, &allocator_info);
+	return allocator_info.physicalDevice;
+}
+
+auto vma::get_allocation_counts() -> AllocationCounts {
+	auto ret = AllocationCounts{};
+	for (auto const [out, count] : std::views::zip(ret, g_counts)) {
+		out.created = count.created;
+		out.live = count.live;
+	}
+	return ret;
+}
+
 auto vma::create_buffer(BufferCreateInfo const& create_info,
 						BufferMemoryType const memory_type,
 						vk::DeviceSize const size) -> Buffer {
@@ -52,7 +114,16 @@ auto vma::create_buffer(BufferCreateInfo const& create_info,
 	allocation_ci.flags =
 		VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
 	auto usage = create_info.usage;
-	if (memory_type == BufferMemoryType::Device) {
+	if (memory_type == BufferMemoryType::DeviceHost &&
+		has_device_host_heap(create_info.allocator)) {
+		// prefer Device local memory that is host visible, let VMA fall back
+		// to memory that isn't (pMappedData will be null then).
+		allocation_ci.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+		allocation_ci.flags |=
+			VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
+			VMA_ALLOCATION_CREATE_MAPPED_BIT;
+		usage |= vk::BufferUsageFlagBits::eTransferDst;
+	} else if (memory_type != BufferMemoryType::Host) {
 		allocation_ci.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
 		// device buffers need to support TransferDst.
 		usage |= vk::BufferUsageFlagBits::eTransferDst;
@@ -79,65 +150,37 @@ auto vma::create_buffer(BufferCreateInfo const& create_info,
 		return {};
 	}
 
+	// Host Buffers that are only copied from are staging Buffers.
+	auto const category = memory_type == BufferMemoryType::Host &&
+								  usage == vk::BufferUsageFlagBits::eTransferSrc
+							  ? AllocationCategory::Staging
+							  : AllocationCategory::Buffer;
+	// shows up in the detailed stats JSON.
+	vmaSetAllocationName(create_info.allocator, allocation,
+						 to_string(category).data());
+	on_created(category);
+
 	return RawBuffer{
 		.allocator = create_info.allocator,
 		.allocation = allocation,
 		.buffer = buffer,
 		.size = size,
 		.mapped = allocation_info.pMappedData,
+		.category = category,
+		.usage = usage,
 	};
 }
 
-auto vma::create_device_buffer(BufferCreateInfo const& create_info,
-							   CommandBlock command_block,
-							   ByteSpans const& byte_spans) -> Buffer {
-	auto const total_size = std::accumulate(
-		byte_spans.begin(), byte_spans.end(), 0uz,
-		[](std::size_t const n, std::span<std::byte const> bytes) {
-			return n + bytes.size();
-		});
-
-	auto staging_ci = create_info;
-	staging_ci.usage = vk::BufferUsageFlagBits::eTransferSrc;
-
-	// create staging Host Buffer with TransferSrc usage.
-	auto staging_buffer =
-		create_buffer(staging_ci, BufferMemoryType::Host, total_size);
-	// create the Device Buffer.
-	auto ret = create_buffer(create_info, BufferMemoryType::Device, total_size);
-	// can't do anything if either buffer creation failed.
-	if (!staging_buffer.get().buffer || !ret.get().buffer) { return {}; }
-
-	// copy byte spans into staging buffer.
-	auto dst = staging_buffer.get().mapped_span();
-	for (auto const bytes : byte_spans) {
-		std::memcpy(dst.data(), bytes.data(), bytes.size());
-		dst = dst.subspan(bytes.size());
-	}
-
-	// record buffer copy operation.
-	auto buffer_copy = vk::BufferCopy2{};
-	buffer_copy.setSize(total_size);
-	auto copy_buffer_info = vk::CopyBufferInfo2{};
-	copy_buffer_info.setSrcBuffer(staging_buffer.get().buffer)
-		.setDstBuffer(ret.get().buffer)
-		.setRegions(buffer_copy);
-	command_block.command_buffer().copyBuffer2(copy_buffer_info);
-
-	// submit and wait.
-	// waiting here is necessary to keep the staging buffer alive while the GPU
-	// accesses it through the recorded commands.
-	// this is also why the function takes ownership of the passed CommandBlock
-	// instead of just referencing it / taking a vk::CommandBuffer.
-	command_block.submit_and_wait();
-
-	return ret;
+void vma::flush_buffer(RawBuffer const& buffer, vk::DeviceSize const offset,
+					   vk::DeviceSize const size) {
+	vmaFlushAllocation(buffer.allocator, buffer.allocation, offset, size);
 }
 
 auto vma::create_image(ImageCreateInfo const& create_info,
 					   vk::ImageUsageFlags const usage,
 					   std::uint32_t const levels, vk::Format const format,
-					   vk::Extent2D const extent) -> Image {
+					   vk::Extent2D const extent, std::uint32_t const layers)
+	-> Image {
 	if (extent.width == 0 || extent.height == 0) {
 		spdlog::error("Images cannot have 0 width or height");
 		return {};
@@ -147,7 +190,7 @@ auto vma::create_image(ImageCreateInfo const& create_info,
 		.setExtent({extent.width, extent.height, 1})
 		.setFormat(format)
 		.setUsage(usage)
-		.setArrayLayers(1)
+		.setArrayLayers(layers)
 		.setMipLevels(levels)
 		.setSamples(vk::SampleCountFlagBits::e1)
 		.setTiling(vk::ImageTiling::eOptimal)
@@ -165,6 +208,9 @@ auto vma::create_image(ImageCreateInfo const& create_info,
 		spdlog::error("Failed to create VMA Image");
 		return {};
 	}
+	vmaSetAllocationName(create_info.allocator, allocation,
+						 to_string(AllocationCategory::Image).data());
+	on_created(AllocationCategory::Image);
 
 	return RawImage{
 		.allocator = create_info.allocator,
@@ -173,87 +219,8 @@ auto vma::create_image(ImageCreateInfo const& create_info,
 		.extent = extent,
 		.format = format,
 		.levels = levels,
+		.layers = layers,
+		.usage = usage,
 	};
 }
-
-auto vma::create_sampled_image(ImageCreateInfo const& create_info,
-							   CommandBlock command_block, Bitmap const& bitmap)
-	-> Image {
-	// create image.
-	// no mip-mapping right now: 1 level.
-	auto const mip_levels = 1u;
-	auto const usize = glm::uvec2{bitmap.size};
-	auto const extent = vk::Extent2D{usize.x, usize.y};
-	auto const usage =
-		vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
-	auto ret = create_image(create_info, usage, mip_levels,
-							vk::Format::eR8G8B8A8Srgb, extent);
-
-	// create staging buffer.
-	auto const buffer_ci = BufferCreateInfo{
-		.allocator = create_info.allocator,
-		.usage = vk::BufferUsageFlagBits::eTransferSrc,
-		.queue_family = create_info.queue_family,
-	};
-	auto const staging_buffer = create_buffer(buffer_ci, BufferMemoryType::Host,
-											  bitmap.bytes.size_bytes());
-
-	// can't do anything if either creation failed.
-	if (!ret.get().image || !staging_buffer.get().buffer) { return {}; }
-
-	// copy bytes into staging buffer.
-	std::memcpy(staging_buffer.get().mapped, bitmap.bytes.data(),
-				bitmap.bytes.size_bytes());
-
-	// transition image for transfer.
-	auto dependency_info = vk::DependencyInfo{};
-	auto subresource_range = vk::ImageSubresourceRange{};
-	subresource_range.setAspectMask(vk::ImageAspectFlagBits::eColor)
-		.setLayerCount(1)
-		.setLevelCount(mip_levels);
-	auto barrier = vk::ImageMemoryBarrier2{};
-	barrier.setImage(ret.get().image)
-		.setSrcQueueFamilyIndex(create_info.queue_family)
-		.setDstQueueFamilyIndex(create_info.queue_family)
-		.setOldLayout(vk::ImageLayout::eUndefined)
-		.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
-		.setSubresourceRange(subresource_range)
-		.setSrcStageMask(vk::PipelineStageFlagBits2::eTopOfPipe)
-		.setSrcAccessMask(vk::AccessFlagBits2::eNone)
-		.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
-		.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead |
-						  vk::AccessFlagBits2::eMemoryWrite);
-	dependency_info.setImageMemoryBarriers(barrier);
-	command_block.command_buffer().pipelineBarrier2(dependency_info);
-
-	// record buffer image copy.
-	auto buffer_image_copy = vk::BufferImageCopy2{};
-	auto subresource_layers = vk::ImageSubresourceLayers{};
-	subresource_layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
-		.setLayerCount(1)
-		.setLayerCount(mip_levels);
-	buffer_image_copy.setImageSubresource(subresource_layers)
-		.setImageExtent(vk::Extent3D{extent.width, extent.height, 1});
-	auto copy_info = vk::CopyBufferToImageInfo2{};
-	copy_info.setDstImage(ret.get().image)
-		.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
-		.setSrcBuffer(staging_buffer.get().buffer)
-		.setRegions(buffer_image_copy);
-	command_block.command_buffer().copyBufferToImage2(copy_info);
-
-	// transition image for sampling.
-	barrier.setOldLayout(barrier.newLayout)
-		.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-		.setSrcStageMask(barrier.dstStageMask)
-		.setSrcAccessMask(barrier.dstAccessMask)
-		.setDstStageMask(vk::PipelineStageFlagBits2::eAllGraphics)
-		.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead |
-						  vk::AccessFlagBits2::eMemoryWrite);
-	dependency_info.setImageMemoryBarriers(barrier);
-	command_block.command_buffer().pipelineBarrier2(dependency_info);
-
-	command_block.submit_and_wait();
-
-	return ret;
-}
 } // namespace lvk
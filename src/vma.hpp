@@ -1,9 +1,10 @@
 #pragma once
 #include <vk_mem_alloc.h>
-#include <bitmap.hpp>
-#include <command_block.hpp>
 #include <scoped.hpp>
 #include <vulkan/vulkan.hpp>
+#include <array>
+#include <span>
+#include <string_view>
 
 namespace lvk::vma {
 struct Deleter {
@@ -12,9 +13,40 @@ struct Deleter {
 
 using Allocator = Scoped<VmaAllocator, Deleter>;
 
+// memory_budget: VK_EXT_memory_budget is enabled on device.
 [[nodiscard]] auto create_allocator(vk::Instance instance,
 									vk::PhysicalDevice physical_device,
-									vk::Device device) -> Allocator;
+									vk::Device device,
+									bool memory_budget = false) -> Allocator;
+
+[[nodiscard]] auto get_physical_device(VmaAllocator allocator)
+	-> vk::PhysicalDevice;
+
+enum class AllocationCategory : std::int8_t { Buffer, Image, Staging };
+inline constexpr std::size_t allocation_category_count_v{3};
+
+[[nodiscard]] constexpr auto to_string(AllocationCategory const category)
+	-> std::string_view {
+	switch (category) {
+	case AllocationCategory::Buffer: return "buffer";
+	case AllocationCategory::Image: return "image";
+	case AllocationCategory::Staging: return "staging";
+	}
+	return "unknown";
+}
+
+struct AllocationCount {
+	std::uint64_t created{};
+	std::uint64_t live{};
+};
+
+// indexed by AllocationCategory.
+using AllocationCounts =
+	std::array<AllocationCount, allocation_category_count_v>;
+
+// counts of Buffers and Images created / destroyed through this API, across
+// all allocators. thread-safe.
+[[nodiscard]] auto get_allocation_counts() -> AllocationCounts;
 
 struct RawBuffer {
 	[[nodiscard]] auto mapped_span() const -> std::span<std::byte> {
@@ -28,6 +60,9 @@ struct RawBuffer {
 	vk::Buffer buffer{};
 	vk::DeviceSize size{};
 	void* mapped{};
+	AllocationCategory category{};
+	// as created, used to recreate the Buffer when its memory is moved.
+	vk::BufferUsageFlags usage{};
 };
 
 struct BufferDeleter {
@@ -42,20 +77,22 @@ struct BufferCreateInfo {
 	std::uint32_t queue_family;
 };
 
-enum class BufferMemoryType : std::int8_t { Host, Device };
+// DeviceHost: Device local and host visible if a large enough heap supports
+// it (ReBAR / UMA), mapped is null otherwise and the contents must be staged
+// into it (usage includes TransferDst).
+enum class BufferMemoryType : std::int8_t { Host, Device, DeviceHost };
 
 [[nodiscard]] auto create_buffer(BufferCreateInfo const& create_info,
 								 BufferMemoryType memory_type,
 								 vk::DeviceSize size) -> Buffer;
 
+// flushes writes to mapped memory, no-op for host coherent memory.
+void flush_buffer(RawBuffer const& buffer, vk::DeviceSize offset,
+				  vk::DeviceSize size);
+
 // disparate byte spans.
 using ByteSpans = std::span<std::span<std::byte const> const>;
 
-// returns a Device Buffer with each byte span sequentially written.
-[[nodiscard]] auto create_device_buffer(BufferCreateInfo const& create_info,
-										CommandBlock command_block,
-										ByteSpans const& byte_spans) -> Buffer;
-
 struct RawImage {
 	auto operator==(RawImage const& rhs) const -> bool = default;
 
@@ -65,6 +102,9 @@ struct RawImage {
 	vk::Extent2D extent{};
 	vk::Format format{};
 	std::uint32_t levels{};
+	std::uint32_t layers{1};
+	// as created, used to recreate the Image when its memory is moved.
+	vk::ImageUsageFlags usage{};
 };
 
 struct ImageDeleter {
@@ -80,10 +120,6 @@ struct ImageCreateInfo {
 
 [[nodiscard]] auto create_image(ImageCreateInfo const& create_info,
 								vk::ImageUsageFlags usage, std::uint32_t levels,
-								vk::Format format, vk::Extent2D extent)
-	-> Image;
-
-[[nodiscard]] auto create_sampled_image(ImageCreateInfo const& create_info,
-										CommandBlock command_block,
-										Bitmap const& bitmap) -> Image;
+								vk::Format format, vk::Extent2D extent,
+								std::uint32_t layers = 1) -> Image;
 } // namespace lvk::vma